@@ -0,0 +1,204 @@
+#include "filters.h"
+#include "log_format.h"
+#include "meca_adapter.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QQueue>
+#include <QString>
+#include <QVector>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+
+namespace {
+
+// Every result goes in here, so the compiler keeps the timed work
+volatile quint64 sink = 0;
+
+// Values of the samples, cycled through by the loops
+const int SAMPLE_COUNT = 4096;
+
+
+// ==========================================================================
+// [ns] per call of work(i), after a warm-up pass
+template <typename Work>
+double timePerCall(int iterations, Work work) {
+    for (int i = 0; i < iterations / 10; ++i) {
+        work(i);
+    }
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        work(i);
+    }
+    return double(timer.nsecsElapsed()) / iterations;
+}
+
+
+void printResult(const char* name, const char* unit, double before,
+                 double after) {
+    std::printf("%-24s %10.1f %10.1f  ns/%s  x%.1f\n", name, before, after,
+                unit, before / after);
+}
+
+
+// ==========================================================================
+// Logger::write text row before formatLogTextRow: a QString per field,
+// encoded to the bytes of the file
+QByteArray formatQStringTextRow(quint64 timestamp, const float* values) {
+    auto msg = QString("%0|%1|%2|%3|%4|%5|%6\n")
+                   .arg(QString::number(timestamp), QString::number(values[0]),
+                        QString::number(values[1]), QString::number(values[2]),
+                        QString::number(values[3]), QString::number(values[4]),
+                        QString::number(values[5]));
+    return msg.toUtf8();
+}
+
+
+// MecaAdapter::moveTwist before formatCommand: the bytes _sendCommand wrote
+QByteArray formatQStringCommand(const float* twist) {
+    return QString("MoveLinVelWRF(%0,%1,%2,%3,%4,%5)\n")
+        .arg(QString::number(twist[0]), QString::number(twist[1]),
+             QString::number(twist[2]), QString::number(twist[3]),
+             QString::number(twist[4]), QString::number(twist[5]))
+        .toUtf8();
+}
+
+
+// SimpleMovingMedian before SlidingMedian: the window is copied and sorted
+// for every sample
+class SortedMovingMedian {
+  public:
+    explicit SortedMovingMedian(int window) : _window(window) {
+        for (auto& buffer : _buffers) {
+            buffer.resize(_window);
+        }
+    }
+
+    QVector<float> applyFilter(const QVector<float>& data) {
+        if (_memory.size() == _window) {
+            _memory.dequeue();
+        }
+        _memory.enqueue(data);
+        QVector<float> median(6);
+        for (int c = 0; c < 6; ++c) {
+            for (int i = 0; i < _memory.size(); ++i) {
+                _buffers[c][i] = _memory[i][c];
+            }
+            std::sort(_buffers[c].begin(), _buffers[c].end());
+            median[c] = _buffers[c][_window / 2];
+        }
+        return median;
+    }
+
+  private:
+    const int              _window;
+    QQueue<QVector<float>> _memory;
+    QVector<float>         _buffers[6];
+};
+
+
+void benchTextRow(const QVector<float>& samples, int iterations) {
+    const quint64 start = 1234567890123ull;  // [ns] a run of ~20 minutes
+    const double  before = timePerCall(iterations, [&](int i) {
+        const float* values = &samples[(i % SAMPLE_COUNT) * 6];
+        sink += formatQStringTextRow(start + i * 1000000ull, values).size();
+    });
+    const double after = timePerCall(iterations, [&](int i) {
+        const float* values = &samples[(i % SAMPLE_COUNT) * 6];
+        char         row[teleop::LOG_TEXT_ROW_SIZE];
+        sink += teleop::formatLogTextRow(row, start + i * 1000000ull, values);
+    });
+    printResult("text log row", "row", before, after);
+}
+
+
+void benchCommand(const QVector<float>& samples, int iterations) {
+    const double before = timePerCall(iterations, [&](int i) {
+        const float* twist = &samples[(i % SAMPLE_COUNT) * 6];
+        sink += formatQStringCommand(twist).size();
+    });
+    const double after = timePerCall(iterations, [&](int i) {
+        const float* twist = &samples[(i % SAMPLE_COUNT) * 6];
+        char         cmd[mecademic::MecaAdapter::commandSize];
+        sink += mecademic::MecaAdapter::formatCommand(
+            cmd, "MoveLinVelWRF",
+            {twist[0], twist[1], twist[2], twist[3], twist[4], twist[5]});
+    });
+    printResult("MoveLinVelWRF command", "command", before, after);
+}
+
+
+void benchMedian(const QVector<float>& samples, int iterations) {
+    // the previous filter took a QVector per sample
+    QVector<QVector<float>> vectors(SAMPLE_COUNT);
+    for (int i = 0; i < SAMPLE_COUNT; ++i) {
+        vectors[i] = QVector<float>(6);
+        std::copy(samples.begin() + i * 6, samples.begin() + i * 6 + 6,
+                  vectors[i].begin());
+    }
+    for (int window : {5, 21, 101, 301}) {
+        SortedMovingMedian sorted(window);
+        const double       before = timePerCall(iterations, [&](int i) {
+            const QVector<float>& data = vectors[i % SAMPLE_COUNT];
+            sink += qint64(sorted.applyFilter(data)[0]);
+        });
+        teleop::SimpleMovingMedian sliding(window);
+        const double               after = timePerCall(iterations, [&](int i) {
+            const int    first = (i % SAMPLE_COUNT) * 6;
+            teleop::Vec6 data;
+            std::copy(samples.begin() + first, samples.begin() + first + 6,
+                      data.values);
+            sink += qint64(sliding.applyFilter(data)[0]);
+        });
+        const QByteArray name = "median w=" + QByteArray::number(window);
+        printResult(name.constData(), "sample", before, after);
+    }
+}
+
+}  // namespace
+
+
+// ==========================================================================
+// Per-call cost of the hot-path code against the implementation it
+// replaced, on random samples. Build in release mode.
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("bench");
+    setlocale(LC_NUMERIC, "C");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Time the log rows, robot commands and moving median against their "
+        "previous implementation");
+    parser.addHelpOption();
+    QCommandLineOption iterations_opt({"n", "iterations"},
+                                      "Calls timed per case.", "count",
+                                      "1000000");
+    parser.addOption(iterations_opt);
+    parser.process(app);
+
+    const int iterations = parser.value(iterations_opt).toInt();
+    if (iterations <= 0) {
+        parser.showHelp(EXIT_FAILURE);
+    }
+
+    // twist-like values, within the MecaAdapter limits
+    std::mt19937                          generator(1);
+    std::uniform_real_distribution<float> distribution(-300, 300);
+    QVector<float>                        samples(SAMPLE_COUNT * 6);
+    for (auto& value : samples) {
+        value = distribution(generator);
+    }
+
+    std::printf("%-24s %10s %10s\n", "", "before", "after");
+    benchTextRow(samples, iterations);
+    benchCommand(samples, iterations);
+    // the sorted median of w=301 takes tens of us per sample
+    benchMedian(samples, qMax(1, iterations / 10));
+    return EXIT_SUCCESS;
+}
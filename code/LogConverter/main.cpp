@@ -0,0 +1,339 @@
+#include "log_codec.h"
+#include "log_reader.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QtEndian>
+
+#include <cstring>
+
+
+namespace {
+
+// ==========================================================================
+// Session rows of the selected channel (all of them if channel < 0)
+bool isSelected(const teleop::LogReader& reader, quint64 row, int channel) {
+    return channel < 0 || reader.getRowChannel(row) == quint32(channel);
+}
+
+
+// ==========================================================================
+// CSV: one line per row, timestamp in [ns]. A whole session has a channel
+// column after the timestamp.
+bool writeCsv(const teleop::LogReader& reader, quint64 first, quint64 last,
+              int channel, QFile& out) {
+    const bool all   = reader.isSession() && channel < 0;
+    QByteArray chunk;
+    for (int c = 0; c < reader.getChannelCount(); ++c) {
+        if (c == channel || channel < 0) {
+            chunk += "# channel=" + reader.getChannel(c).toUtf8() +
+                     " units=" + reader.getUnits(c).toUtf8() + "\n";
+        }
+    }
+    chunk += all ? "timestamp,channel" : "timestamp";
+    for (int f = 0; f < reader.getFieldCount(); ++f) {
+        chunk += ",v" + QByteArray::number(f);
+    }
+    chunk += '\n';
+    for (quint64 row = first; row < last; ++row) {
+        if (!isSelected(reader, row, channel)) {
+            continue;
+        }
+        chunk += QByteArray::number(reader.getTimestamp(row));
+        if (all) {
+            chunk += ',';
+            chunk += reader.getChannel(reader.getRowChannel(row)).toUtf8();
+        }
+        for (int f = 0; f < reader.getFieldCount(); ++f) {
+            chunk += ',';
+            chunk += QByteArray::number(reader.getValue(row, f), 'g', 9);
+        }
+        chunk += '\n';
+        if (chunk.size() > (1 << 20)) {
+            if (out.write(chunk) != chunk.size()) {
+                return false;
+            }
+            chunk.clear();
+        }
+    }
+    return out.write(chunk) == chunk.size();
+}
+
+
+// ==========================================================================
+// NPY v1.0: 1-D structured array whose dtype matches the binary row layout,
+// so the selected rows are copied straight from the mapping. A session keeps
+// its channel column (id in the channel table, see --info).
+bool writeNpy(const teleop::LogReader& reader, quint64 first, quint64 last,
+              int channel, QFile& out) {
+    quint64 count = last - first;
+    if (reader.isSession() && channel >= 0) {
+        count = 0;
+        for (quint64 row = first; row < last; ++row) {
+            count += isSelected(reader, row, channel);
+        }
+    }
+    QByteArray descr = reader.isSession()
+                           ? "[('timestamp', '<u8'), ('channel', '<u4')"
+                           : "[('timestamp', '<u8')";
+    for (int f = 0; f < reader.getFieldCount(); ++f) {
+        descr += ", ('v" + QByteArray::number(f) + "', '<f4')";
+    }
+    descr += "]";
+    QByteArray dict = "{'descr': " + descr +
+                      ", 'fortran_order': False, 'shape': (" +
+                      QByteArray::number(count) + ",), }";
+    // magic(6) + version(2) + len(2) + dict + '\n' aligned to 64 bytes
+    int total = 10 + dict.size() + 1;
+    dict += QByteArray((64 - total % 64) % 64, ' ');
+    dict += '\n';
+
+    char preamble[10] = {'\x93', 'N', 'U', 'M', 'P', 'Y', 1, 0, 0, 0};
+    qToLittleEndian<quint16>(dict.size(), preamble + 8);
+    if (out.write(preamble, sizeof(preamble)) != qint64(sizeof(preamble)) ||
+        out.write(dict) != dict.size()) {
+        return false;
+    }
+    if (reader.isSession() && channel >= 0) {
+        QByteArray chunk;
+        for (quint64 row = first; row < last; ++row) {
+            if (isSelected(reader, row, channel)) {
+                chunk.append(reader.getRowData(row), reader.getRowSize());
+            }
+            if (chunk.size() > (1 << 20)) {
+                if (out.write(chunk) != chunk.size()) {
+                    return false;
+                }
+                chunk.clear();
+            }
+        }
+        return out.write(chunk) == chunk.size();
+    }
+    const qint64 step = qint64(1) << 24;  // write at most 16MB at once
+    const qint64 size = (last - first) * reader.getRowSize();
+    const char*  data = reader.getRowData(first);
+    for (qint64 done = 0; done < size; done += step) {
+        qint64 len = qMin(step, size - done);
+        if (out.write(data + done, len) != len) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// ==========================================================================
+// Compressed log (log_<name>.zlog): streamed through a LogDecoder into a
+// plain binary log, so that the LogReader can map it
+bool isCompressed(const QString& path) {
+    QFile in(path);
+    char  magic[8];
+    return in.open(QFile::ReadOnly) &&
+           in.read(magic, sizeof(magic)) == qint64(sizeof(magic)) &&
+           std::memcmp(magic, teleop::LOG_COMPRESSED_MAGIC, sizeof(magic)) ==
+               0;
+}
+
+
+bool decompress(const QString& path, QFile& out) {
+    QFile in(path);
+    if (!in.open(QFile::ReadOnly)) {
+        qCritical() << "Cannot open" << path << ":" << in.errorString();
+        return false;
+    }
+    teleop::LogCompressedHeader header;
+    if (in.read(reinterpret_cast<char*>(&header), sizeof(header)) !=
+            qint64(sizeof(header)) ||
+        !in.seek(qFromLittleEndian<quint16>(header.headerSize))) {
+        qCritical() << "Truncated header:" << path;
+        return false;
+    }
+    float steps[teleop::LOG_FIELD_COUNT];
+    for (int i = 0; i < teleop::LOG_FIELD_COUNT; ++i) {
+        quint32 bits = qFromLittleEndian<quint32>(&header.steps[i]);
+        std::memcpy(&steps[i], &bits, sizeof(bits));
+    }
+    auto channel = QString::fromUtf8(
+        header.channel, qstrnlen(header.channel, teleop::LOG_NAME_LENGTH));
+    auto units = QString::fromUtf8(
+        header.units, qstrnlen(header.units, teleop::LOG_UNITS_LENGTH));
+    auto file_header = teleop::makeLogFileHeader(channel, units);
+    if (out.write(reinterpret_cast<const char*>(&file_header),
+                  sizeof(file_header)) != qint64(sizeof(file_header))) {
+        return false;
+    }
+
+    teleop::LogDecoder decoder(steps);
+    quint64            timestamp;
+    float              values[teleop::LOG_FIELD_COUNT];
+    char               row[8 + 4 * teleop::LOG_FIELD_COUNT];
+    QByteArray         chunk;
+    while (!in.atEnd()) {
+        QByteArray data = in.read(1 << 20);
+        decoder.feed(data.constData(), data.size());
+        while (decoder.next(timestamp, values)) {
+            teleop::encodeLogRow(row, timestamp, values,
+                                 teleop::LOG_FIELD_COUNT);
+            chunk.append(row, sizeof(row));
+        }
+        if (out.write(chunk) != chunk.size()) {
+            return false;
+        }
+        chunk.clear();
+    }
+    if (decoder.getPendingBytes() > 0) {
+        qWarning() << "Ignored a truncated last row of"
+                   << decoder.getPendingBytes() << "bytes";
+    }
+    return out.flush();
+}
+
+}  // namespace
+
+
+// ==========================================================================
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("log_converter");
+    setlocale(LC_NUMERIC, "C");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Convert a binary teleoperation log (log_<name>.bin), compressed log "
+        "(log_<name>.zlog) or session (log_session.bin) to CSV or NPY");
+    parser.addHelpOption();
+    QCommandLineOption format_opt(
+        {"f", "format"},
+        "Output format: csv, npy, bin (compressed log to binary log).",
+        "format", "csv");
+    QCommandLineOption from_opt("from", "Start time [s] (inclusive).",
+                                "seconds");
+    QCommandLineOption to_opt("to", "End time [s] (exclusive).", "seconds");
+    QCommandLineOption output_opt({"o", "output"},
+                                  "Output file (default: <input>.<format>).",
+                                  "file");
+    QCommandLineOption info_opt({"i", "info"},
+                                "Print header and time span, then exit.");
+    QCommandLineOption channel_opt({"c", "channel"},
+                                   "Session only: keep a single channel.",
+                                   "name");
+    parser.addOption(format_opt);
+    parser.addOption(from_opt);
+    parser.addOption(to_opt);
+    parser.addOption(output_opt);
+    parser.addOption(info_opt);
+    parser.addOption(channel_opt);
+    parser.addPositionalArgument("input", "Binary log file.");
+    parser.process(app);
+
+    const auto args = parser.positionalArguments();
+    if (args.size() != 1) {
+        parser.showHelp(EXIT_FAILURE);
+    }
+
+    const QString format = parser.value(format_opt);
+    if (format != "csv" && format != "npy" && format != "bin") {
+        qCritical() << "Unknown format:" << format;
+        return EXIT_FAILURE;
+    }
+    QString output = parser.value(output_opt);
+    if (output.isEmpty()) {
+        QFileInfo info(args[0]);
+        output = info.absolutePath() + "/" + info.completeBaseName() + "." +
+                 format;
+    }
+
+    // A compressed log is expanded first (to the output if --format bin)
+    QString        input = args[0];
+    QTemporaryFile expanded;
+    if (isCompressed(input)) {
+        if (format == "bin") {
+            QFile out(output);
+            if (!out.open(QFile::WriteOnly) || !decompress(input, out)) {
+                qCritical() << "Error writing" << output;
+                return EXIT_FAILURE;
+            }
+            qInfo() << "Decompressed" << input << "to" << output;
+            return EXIT_SUCCESS;
+        }
+        if (!expanded.open() || !decompress(input, expanded)) {
+            qCritical() << "Cannot decompress" << input;
+            return EXIT_FAILURE;
+        }
+        input = expanded.fileName();
+    } else if (format == "bin") {
+        qCritical() << "bin format requires a compressed log";
+        return EXIT_FAILURE;
+    }
+
+    teleop::LogReader reader;
+    if (!reader.open(input)) {
+        return EXIT_FAILURE;
+    }
+    const quint64 rows = reader.getRowCount();
+
+    if (parser.isSet(info_opt)) {
+        QTextStream stream(stdout);
+        for (int c = 0; c < reader.getChannelCount(); ++c) {
+            stream << "channel: " << reader.getChannel(c);
+            if (reader.isSession()) {
+                stream << " (id " << c << ")";
+            }
+            stream << "\n"
+                   << "units:   " << reader.getUnits(c) << "\n";
+        }
+        stream << "fields:  " << reader.getFieldCount() << "\n"
+               << "rows:    " << rows << "\n";
+        stream.flush();
+        if (rows > 0) {
+            QTextStream(stdout)
+                << "span:    " << reader.getTimestamp(0) * 1e-9 << " s -> "
+                << reader.getTimestamp(rows - 1) * 1e-9 << " s\n";
+        }
+        return EXIT_SUCCESS;
+    }
+
+    int channel = -1;
+    if (parser.isSet(channel_opt)) {
+        channel = reader.findChannel(parser.value(channel_opt));
+        if (channel < 0) {
+            qCritical() << "Unknown channel:" << parser.value(channel_opt);
+            return EXIT_FAILURE;
+        }
+        if (!reader.isSession()) {
+            channel = -1;  // the only one
+        }
+    }
+
+    // Select the time range with a binary search on the timestamps
+    quint64 first = 0;
+    quint64 last  = rows;
+    if (parser.isSet(from_opt)) {
+        first = reader.lowerBound(parser.value(from_opt).toDouble() * 1e9);
+    }
+    if (parser.isSet(to_opt)) {
+        last = reader.lowerBound(parser.value(to_opt).toDouble() * 1e9);
+    }
+    last = qMax(first, last);
+
+    QFile out(output);
+    if (!out.open(QFile::WriteOnly)) {
+        qCritical() << "Cannot open" << output << ":" << out.errorString();
+        return EXIT_FAILURE;
+    }
+
+    bool ok = (format == "csv") ? writeCsv(reader, first, last, channel, out)
+                                : writeNpy(reader, first, last, channel, out);
+    out.close();
+    if (!ok) {
+        qCritical() << "Error writing" << output;
+        return EXIT_FAILURE;
+    }
+    qInfo() << "Written rows" << first << "->" << last << "to" << output;
+    return EXIT_SUCCESS;
+}
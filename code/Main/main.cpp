@@ -1,6 +1,13 @@
 #include "kinematic.h"
+#include "latency.h"
+#include "log_warning.h"
 #include "logs.h"
+#include "metrics_server.h"
+#include "perf_counters.h"
+#include "queue_monitor.h"
+#include "sched_sampler.h"
 #include "supervisor.h"
+#include "trace.h"
 
 #include <QCoreApplication>
 #include <QDebug>
@@ -15,6 +22,8 @@ int main(int argc, char* argv[]) {
     qDebug() << QThread::currentThreadId() << " | Main";
 
     qInstallMessageHandler(teleop::messageHandler);
+    teleop::MessageWriter::getInstance().enable();
+    teleop::FlightRecorder::getInstance().installSignalHandler();
     QLoggingCategory::setFilterRules("*                   = true\n"
                                      "Logger.info         = true\n"
                                      "Kinematic.info      = true\n"
@@ -34,12 +43,30 @@ int main(int argc, char* argv[]) {
                                      "MecaAdapter.debug   = false\n"
                                      "Generators.debug    = false\n");
 
+    // before the nodes start writing: the sched_main channel must be in
+    // the session header
+    teleop::SchedSampler::getInstance().attach("Main");
+
     teleop::Supervisor brain(&app);
     QObject::connect(&brain, &teleop::Supervisor::finished, &app,
                      &QCoreApplication::quit, Qt::QueuedConnection);
     QObject::connect(&brain, &teleop::Supervisor::finished,
                      []() { qDebug() << "Quit"; });
     brain.start();
+    teleop::MetricsServer::getInstance().enable();
+    teleop::SchedSampler::getInstance().enable();
+    teleop::LogWriter::getInstance().enable();  // reports, TSC calibration
 
-    return app.exec();
+    teleop::Tracer::getInstance().setThreadName("Main");
+    int result = app.exec();
+    teleop::MetricsServer::getInstance().disable();
+    teleop::SchedSampler::getInstance().disable();
+    teleop::LogWriter::getInstance().disable();
+    teleop::SchedSampler::getInstance().report();
+    teleop::WarningRegistry::getInstance().report();
+    teleop::LatencyMonitor::getInstance().report();
+    teleop::QueueMonitor::getInstance().report();
+    teleop::PerfMonitor::getInstance().report();
+    teleop::Tracer::getInstance().exportJson();
+    return result;
 }
@@ -1,9 +1,14 @@
 #include "meca_adapter.h"
+#include "log_warning.h"
+#include "number_format.h"
+#include "queue_monitor.h"
 
 #include <QDateTime>
 #include <QDebug>
 #include <QThread>
 
+#include <cstring>
+
 Q_LOGGING_CATEGORY(logMecaAdapter, "MecaAdapter")
 
 
@@ -40,6 +45,28 @@ mecademic::MecaAdapter::MecaAdapter(QObject* parent) : QObject(parent) {
             &MecaAdapter::_onMonitoringErrorOccurred);
     connect(_monitoringSocket, &QTcpSocket::readyRead, this,
             &MecaAdapter::_onMonitoringReadyRead);
+    // METRICS
+    auto& metrics   = teleop::MetricsRegistry::getInstance();
+    _commandsMetric = &metrics.getCounter("teleop_robot_commands_total",
+                                          "Commands sent to the robot");
+    _commandErrorsMetric =
+        &metrics.getCounter("teleop_robot_command_errors_total",
+                            "Commands not written to the control socket");
+    _saturationsMetric =
+        &metrics.getCounter("teleop_robot_saturations_total",
+                            "Command parameters clamped to the robot limits");
+    _framesMetric =
+        &metrics.getCounter("teleop_robot_monitoring_frames_total",
+                            "Frames parsed from the monitoring port");
+    _parseErrorsMetric =
+        &metrics.getCounter("teleop_robot_parse_errors_total",
+                            "Malformed frames of the monitoring port");
+    _activatedMetric = &metrics.getGauge("teleop_robot_activated",
+                                         "Robot activated (0 or 1)");
+    _homedMetric =
+        &metrics.getGauge("teleop_robot_homed", "Robot homed (0 or 1)");
+    _errorMetric =
+        &metrics.getGauge("teleop_robot_in_error", "Robot in error (0 or 1)");
 }
 
 
@@ -51,14 +78,13 @@ mecademic::MecaAdapter::~MecaAdapter() {
 // --------------------------------------------------------------------------
 // MOTION COMMANDS
 void mecademic::MecaAdapter::delay(float sec) {
-    _sendCommand(QString("Delay(%0)\n").arg(QString::number(sec)));
+    _sendCommand("Delay", {sec});
 }
 
 
 void mecademic::MecaAdapter::setCheckpoint(int n) {
     //    [3030][n]
-    _sendCommand(
-        QString("SetCheckpoint(%0)\n").arg(QString::number(_norm(n, 1, 8000))));
+    _sendCommand("SetCheckpoint", {_norm(n, 1, 8000)});
 }
 
 
@@ -70,213 +96,189 @@ unsigned mecademic::MecaAdapter::addCheckpoint() {
 }
 
 
-void mecademic::MecaAdapter::setTCP(const QVector<float>& tcp) {
-    _sendCommand(QString("SetTRF(%0,%1,%2,%3,%4,%5)\n")
-                     .arg(QString::number(tcp[0]), QString::number(tcp[1]),
-                          QString::number(tcp[2]), QString::number(tcp[3]),
-                          QString::number(tcp[4]), QString::number(tcp[5])));
+void mecademic::MecaAdapter::setTCP(const teleop::Vec6& tcp) {
+    _sendCommand("SetTRF", {tcp[0], tcp[1], tcp[2], tcp[3], tcp[4], tcp[5]});
 }
 
 
 void mecademic::MecaAdapter::setCartLinVel(float v) {
-    _sendCommand(QString("SetCartLinVel(%0)\n")
-                     .arg(QString::number(_norm(v, 0.0010, 1000))));
+    _sendCommand("SetCartLinVel", {_norm(v, 0.0010, 1000)});
 }
 
 
 void mecademic::MecaAdapter::setCartAngVel(float w) {
-    _sendCommand(QString("SetCartAngVel(%0)\n")
-                     .arg(QString::number(_norm(w, 0.0010, 300))));
+    _sendCommand("SetCartAngVel", {_norm(w, 0.0010, 300)});
 }
 
 
 void mecademic::MecaAdapter::setCartAcc(float perc) {
-    _sendCommand(QString("SetCartAcc(%0)\n")
-                     .arg(QString::number(_norm(perc, 0.001, 600))));
+    _sendCommand("SetCartAcc", {_norm(perc, 0.001, 600)});
 }
 
 
 void mecademic::MecaAdapter::setJointVel(float perc) {
-    _sendCommand(QString("SetJointVel(%0)\n")
-                     .arg(QString::number(_norm(perc, 0.001, 100))));
+    _sendCommand("SetJointVel", {_norm(perc, 0.001, 100)});
 }
 
 
 void mecademic::MecaAdapter::setJointAcc(float perc) {
-    _sendCommand(QString("SetJointAcc(%0)\n")
-                     .arg(QString::number(_norm(perc, 0.001, 150))));
+    _sendCommand("SetJointAcc", {_norm(perc, 0.001, 150)});
 }
 
 
 void mecademic::MecaAdapter::setBlending(float perc) {
-    _sendCommand(
-        QString("SetBlending(%0)\n").arg(QString::number(_norm(perc, 0, 100))));
+    _sendCommand("SetBlending", {_norm(perc, 0, 100)});
 }
 
 
 void mecademic::MecaAdapter::setConf(int shoulder, int elbow, int wrist) {
-    _sendCommand(QString("SetConf(%0,%1,%2)\n")
-                     .arg(QString::number(_normConf(shoulder)),
-                          QString::number(_normConf(elbow)),
-                          QString::number(_normConf(wrist))));
+    _sendCommand("SetConf", {double(_normConf(shoulder)),
+                             double(_normConf(elbow)),
+                             double(_normConf(wrist))});
 }
 
 
 void mecademic::MecaAdapter::setConfTurn(int turn) {
-    _sendCommand(QString("setConfTurn(%0)\n")
-                     .arg(QString::number(_norm(turn, -100, 100))));
+    _sendCommand("setConfTurn", {_norm(turn, -100, 100)});
 }
 
 
 void mecademic::MecaAdapter::setAutoConf(bool enable) {
-    _sendCommand(QString("SetAutoConf(%0)\n").arg(QString::number(enable)));
+    _sendCommand("SetAutoConf", {double(enable)});
 }
 
 
 void mecademic::MecaAdapter::setAutoConfTurn(bool enable) {
-    _sendCommand(QString("SetAutoConfTurn(%0)\n").arg(QString::number(enable)));
+    _sendCommand("SetAutoConfTurn", {double(enable)});
 }
 
 
-void mecademic::MecaAdapter::moveJoints(const QVector<float>& joints) {
-    _sendCommand(QString("MoveJoints(%0,%1,%2,%3,%4,%5)\n")
-                     .arg(QString::number(_norm(joints[0], -175, 175)),
-                          QString::number(_norm(joints[1], -70, 90)),
-                          QString::number(_norm(joints[2], -135, 70)),
-                          QString::number(_norm(joints[3], -170, 170)),
-                          QString::number(_norm(joints[4], -115, 115)),
-                          QString::number(_norm(joints[5], -36000, 36000))));
+void mecademic::MecaAdapter::moveJoints(const teleop::Vec6& joints) {
+    _sendCommand("MoveJoints", {_norm(joints[0], -175, 175),
+                                _norm(joints[1], -70, 90),
+                                _norm(joints[2], -135, 70),
+                                _norm(joints[3], -170, 170),
+                                _norm(joints[4], -115, 115),
+                                _norm(joints[5], -36000, 36000)});
 }
 
 
-void mecademic::MecaAdapter::moveLin(const QVector<float>& pose) {
-    _sendCommand(QString("MoveLin(%0,%1,%2,%3,%4,%5)\n\n")
-                     .arg(QString::number(pose[0]), QString::number(pose[1]),
-                          QString::number(pose[2]), QString::number(pose[3]),
-                          QString::number(pose[4]), QString::number(pose[5])));
+void mecademic::MecaAdapter::moveLin(const teleop::Vec6& pose) {
+    _sendCommand("MoveLin",
+                 {pose[0], pose[1], pose[2], pose[3], pose[4], pose[5]});
 }
 
 
-void mecademic::MecaAdapter::moveLinRel(const QVector<float>& pose) {
-    _sendCommand(QString("MoveLinRelTRF(%0,%1,%2,%3,%4,%5)\n")
-                     .arg(QString::number(pose[0]), QString::number(pose[1]),
-                          QString::number(pose[2]), QString::number(pose[3]),
-                          QString::number(pose[4]), QString::number(pose[5])));
+void mecademic::MecaAdapter::moveLinRel(const teleop::Vec6& pose) {
+    _sendCommand("MoveLinRelTRF",
+                 {pose[0], pose[1], pose[2], pose[3], pose[4], pose[5]});
 }
 
 
-void mecademic::MecaAdapter::movePose(const QVector<float>& pose) {
-    _sendCommand(QString("MovePose(%0,%1,%2,%3,%4,%5)\n")
-                     .arg(QString::number(pose[0]), QString::number(pose[1]),
-                          QString::number(pose[2]), QString::number(pose[3]),
-                          QString::number(pose[4]), QString::number(pose[5])));
+void mecademic::MecaAdapter::movePose(const teleop::Vec6& pose) {
+    _sendCommand("MovePose",
+                 {pose[0], pose[1], pose[2], pose[3], pose[4], pose[5]});
 }
 
 
 void mecademic::MecaAdapter::setVelTimeout(float sec) {
-    _sendCommand(QString("SetVelTimeout(%0)\n")
-                     .arg(QString::number(_norm(sec, 0.001, 1))));
+    _sendCommand("SetVelTimeout", {_norm(sec, 0.001, 1)});
 }
 
 
-void mecademic::MecaAdapter::moveJointVel(const QVector<float>& jointsVel) {
-    _sendCommand(QString("MoveJointsVel(%0,%1,%2,%3,%4,%5)\n")
-                     .arg(QString::number(_norm(jointsVel[0], -150, 150)),
-                          QString::number(_norm(jointsVel[1], -150, 150)),
-                          QString::number(_norm(jointsVel[2], -180, 180)),
-                          QString::number(_norm(jointsVel[3], -300, 300)),
-                          QString::number(_norm(jointsVel[4], -300, 300)),
-                          QString::number(_norm(jointsVel[5], -300, 300))));
+void mecademic::MecaAdapter::moveJointVel(const teleop::Vec6& jointsVel) {
+    _sendCommand("MoveJointsVel", {_norm(jointsVel[0], -150, 150),
+                                   _norm(jointsVel[1], -150, 150),
+                                   _norm(jointsVel[2], -180, 180),
+                                   _norm(jointsVel[3], -300, 300),
+                                   _norm(jointsVel[4], -300, 300),
+                                   _norm(jointsVel[5], -300, 300)});
 }
 
 
-void mecademic::MecaAdapter::moveTwist(const QVector<float>& twist) {
-    _sendCommand(QString("MoveLinVelWRF(%0,%1,%2,%3,%4,%5)\n")
-                     .arg(QString::number(_norm(twist[0], -1000, 1000)),
-                          QString::number(_norm(twist[1], -1000, 1000)),
-                          QString::number(_norm(twist[2], -1000, 1000)),
-                          QString::number(_norm(twist[3], -300, 300)),
-                          QString::number(_norm(twist[4], -300, 300)),
-                          QString::number(_norm(twist[5], -300, 300))));
+void mecademic::MecaAdapter::moveTwist(const teleop::Vec6& twist) {
+    _sendCommand("MoveLinVelWRF", {_norm(twist[0], -1000, 1000),
+                                   _norm(twist[1], -1000, 1000),
+                                   _norm(twist[2], -1000, 1000),
+                                   _norm(twist[3], -300, 300),
+                                   _norm(twist[4], -300, 300),
+                                   _norm(twist[5], -300, 300)});
 }
 
 
 void mecademic::MecaAdapter::setGripperVel(float perc) {
-    _sendCommand(QString("SetGripperVel(%0)\n")
-                     .arg(QString::number(_norm(perc, 5, 100))));
+    _sendCommand("SetGripperVel", {_norm(perc, 5, 100)});
 }
 
 
 void mecademic::MecaAdapter::setGripperForce(float perc) {
-    _sendCommand(QString("SetGripperForce(%0)\n")
-                     .arg(QString::number(_norm(perc, 5, 100))));
+    _sendCommand("SetGripperForce", {_norm(perc, 5, 100)});
 }
 
 
 void mecademic::MecaAdapter::gripperOpen() {
-    _sendCommand(QString("GripperOpen\n"));
+    _sendCommand("GripperOpen");
 }
 
 
 void mecademic::MecaAdapter::gripperClose() {
-    _sendCommand(QString("GripperClose\n"));
+    _sendCommand("GripperClose");
 }
 
 // --------------------------------------------------------------------------
 // REQUEST COMMANDS
 void mecademic::MecaAdapter::activateRobot() {
-    _sendCommand(QString("ActivateRobot\n"));
+    _sendCommand("ActivateRobot");
 }
 
 
 void mecademic::MecaAdapter::deactivateRobot() {
-    _sendCommand(QString("DeactivateRobot\n"));
+    _sendCommand("DeactivateRobot");
 }
 
 
 void mecademic::MecaAdapter::activateSim() {
-    _sendCommand(QString("ActivateSim\n"));
+    _sendCommand("ActivateSim");
 }
 
 
 void mecademic::MecaAdapter::deactivateSim() {
-    _sendCommand(QString("DeactivateSim\n"));
+    _sendCommand("DeactivateSim");
 }
 
 
 void mecademic::MecaAdapter::homing() {
-    _sendCommand(QString("Home\n"));
+    _sendCommand("Home");
 }
 
 
 void mecademic::MecaAdapter::resetError() {
-    _sendCommand(QString("ResetError\n"));
+    _sendCommand("ResetError");
 }
 
 
 void mecademic::MecaAdapter::pauseMotion() {
-    _sendCommand(QString("PauseMotion\n"));
+    _sendCommand("PauseMotion");
 }
 
 
 void mecademic::MecaAdapter::resumeMotion() {
-    _sendCommand(QString("ResumeMotion\n"));
+    _sendCommand("ResumeMotion");
 }
 
 
 void mecademic::MecaAdapter::clearMotion() {
-    _sendCommand(QString("ClearMotion\n"));
+    _sendCommand("ClearMotion");
 }
 
 
 void mecademic::MecaAdapter::getCmdPendingCount() {
-    _sendCommand(QString("GetCmdPendingCount\n"));
+    _sendCommand("GetCmdPendingCount");
 }
 
 
 void mecademic::MecaAdapter::setMonitoringInterval(float sec) {
-    _sendCommand(QString("SetMonitoringInterval(%0)\n")
-                     .arg(QString::number(_norm(sec, 0.001, 1))));
+    _sendCommand("SetMonitoringInterval", {_norm(sec, 0.001, 1)});
 }
 
 
@@ -342,22 +344,22 @@ mecademic::MecaStatus mecademic::MecaAdapter::getRobotStatus() const {
 }
 
 
-QVector<float> mecademic::MecaAdapter::getJoints() const {
+teleop::Vec6 mecademic::MecaAdapter::getJoints() const {
     return _currJoints;
 }
 
 
-QVector<float> mecademic::MecaAdapter::getPose() const {
+teleop::Vec6 mecademic::MecaAdapter::getPose() const {
     return _currPose;
 }
 
 
-QVector<float> mecademic::MecaAdapter::getJointVel() const {
+teleop::Vec6 mecademic::MecaAdapter::getJointVel() const {
     return _currJointVel;
 }
 
 
-QVector<float> mecademic::MecaAdapter::getTwist() const {
+teleop::Vec6 mecademic::MecaAdapter::getTwist() const {
     return _currTwist;
 }
 
@@ -369,31 +371,60 @@ unsigned mecademic::MecaAdapter::getTime() const {
 // --------------------------------------------------------------------------
 // PRIVATE
 void mecademic::MecaAdapter::_setRealTimeMonitoring() {
-    _sendCommand(QString("SetRealTimeMonitoring(2210, 2211, 2212, 2214)\n"));
+    _sendCommand("SetRealTimeMonitoring", {2210, 2211, 2212, 2214});
 }
 
 
 void mecademic::MecaAdapter::_setTime() {
     qint64 time = QDateTime::currentDateTime().toSecsSinceEpoch();
-    _sendCommand(QString("SetRTC(%0)\n").arg(QString::number(time)));
+    _sendCommand("SetRTC", {double(time)});
+}
+
+
+int mecademic::MecaAdapter::formatCommand(
+    char* cmd, const char* name, std::initializer_list<double> args) {
+    int size = qMin(int(std::strlen(name)), commandSize / 2);
+    std::memcpy(cmd, name, size);
+    if (args.size() > 0) {
+        char separator = '(';
+        for (double arg : args) {
+            if (size + 1 + teleop::NUMBER_FORMAT_SIZE + 2 > commandSize) {
+                break;
+            }
+            cmd[size++] = separator;
+            size += teleop::formatFixed(cmd + size, arg, commandDecimals);
+            separator = ',';
+        }
+        cmd[size++] = ')';
+    }
+    cmd[size++] = '\n';
+    return size;
 }
 
 
-void mecademic::MecaAdapter::_sendCommand(const QString& cmd) {
-    _controlSocket->write(cmd.toUtf8());
+void mecademic::MecaAdapter::_sendCommand(const char*                   name,
+                                          std::initializer_list<double> args) {
+    char      cmd[commandSize];
+    const int size = formatCommand(cmd, name, args);
+    _controlSocket->write(cmd, size);
+    _commandsMetric->increment();
     if (!_controlSocket->waitForBytesWritten()) {
-        qWarning(logMecaAdapter()) << "Error in sending this command: " << cmd;
+        _commandErrorsMetric->increment();
+        qWarning(logMecaAdapter()) << "Error in sending this command: "
+                                   << QByteArray(cmd, size);
     }
 }
 
 
 float mecademic::MecaAdapter::_norm(float val, float min, float max) {
     if (val < min) {
-        qWarning(logMecaAdapter()) << "normalize " << val << "to " << min;
+        _saturationsMetric->increment();
+        TELEOP_WARN_AGGREGATED(logMecaAdapter, "normalize to min", val);
         return min;
     }
     if (val > max) {
-        qWarning(logMecaAdapter()) << "normalize " << val << "to " << max;
+        _saturationsMetric->increment();
+        TELEOP_WARN_AGGREGATED(logMecaAdapter, "normalize to max", val);
         return max;
     }
     return val;
@@ -404,11 +435,12 @@ int mecademic::MecaAdapter::_normConf(int val) {
     if (val == -1 || val == 1) {
         return val;
     }
+    _saturationsMetric->increment();
     if (val < -1) {
-        qWarning(logMecaAdapter()) << "normalize " << val << "to -1";
+        TELEOP_WARN_AGGREGATED(logMecaAdapter, "normalize conf to -1", val);
         return -1;
     }
-    qWarning(logMecaAdapter()) << "normalize " << val << "to +1";
+    TELEOP_WARN_AGGREGATED(logMecaAdapter, "normalize conf to +1", val);
     return 1;
 }
 
@@ -416,7 +448,7 @@ int mecademic::MecaAdapter::_normConf(int val) {
 void mecademic::MecaAdapter::_processControlReply(const QByteArray& reply) {
     unsigned code = reply.mid(1, 4).toUInt();
     QString  msg  = reply.mid(7, reply.size() - 8);
-    //    qDebug(logMecaAdapter()) << "[Control   ] " << reply;
+    //    TELEOP_DEBUG(logMecaAdapter) << "[Control   ] " << reply;
 
     if (code > 3000) {
         switch (code) {
@@ -461,7 +493,7 @@ void mecademic::MecaAdapter::_processControlReply(const QByteArray& reply) {
                 break;
             }
             default: {
-                //                qDebug(logMecaAdapter()) << reply;
+                //                TELEOP_DEBUG(logMecaAdapter) << reply;
             }
         }
     }
@@ -471,7 +503,7 @@ void mecademic::MecaAdapter::_processControlReply(const QByteArray& reply) {
 void mecademic::MecaAdapter::_processMonitoringReply(const QByteArray& reply) {
     unsigned code = reply.mid(1, 4).toUInt();
     QString  msg  = reply.mid(7, reply.size() - 8);
-    //    qDebug(logMecaAdapter()) << "[Monitoring] " << reply;
+    //    TELEOP_DEBUG(logMecaAdapter) << "[Monitoring] " << reply;
 
     // clang-format off
     /* ERROR FOUND:
@@ -480,6 +512,7 @@ void mecademic::MecaAdapter::_processMonitoringReply(const QByteArray& reply) {
     */
     // clang-format on
 
+    _framesMetric->increment();
     switch (code) {
         case 2030: {
             _currTimeStamp = msg.toUInt();
@@ -487,6 +520,11 @@ void mecademic::MecaAdapter::_processMonitoringReply(const QByteArray& reply) {
         }
         case 2007: {
             auto list = msg.split(",");
+            if (list.size() < 7) {
+                _parseErrorsMetric->increment();
+                qWarning(logMecaAdapter()) << "size error with 2007" << reply;
+                break;
+            }
             // Update state
             _currRobotStatus.activated     = list[0].toInt();
             _currRobotStatus.homed         = list[1].toInt();
@@ -495,12 +533,17 @@ void mecademic::MecaAdapter::_processMonitoringReply(const QByteArray& reply) {
             _currRobotStatus.inPauseMotion = list[4].toInt();
             _currRobotStatus.endOfBlock    = list[5].toInt();
             _currRobotStatus.endOfMovement = list[6].toInt();
+            _activatedMetric->set(_currRobotStatus.activated);
+            _homedMetric->set(_currRobotStatus.homed);
+            _errorMetric->set(_currRobotStatus.inError);
             break;
         }
         case 2210: {
             auto list = msg.split(",");
             if (list.size() < 7) {
+                _parseErrorsMetric->increment();
                 qWarning(logMecaAdapter()) << "size error with 2210" << reply;
+                break;
             }
             for (int i = 0; i < 6; ++i) {
                 _currJoints[i] = list[1 + i].toFloat();
@@ -510,7 +553,9 @@ void mecademic::MecaAdapter::_processMonitoringReply(const QByteArray& reply) {
         case 2211: {
             auto list = msg.split(",");
             if (list.size() < 7) {
+                _parseErrorsMetric->increment();
                 qWarning(logMecaAdapter()) << "size error with 2211" << reply;
+                break;
             }
             for (int i = 0; i < 6; ++i) {
                 _currPose[i] = list[1 + i].toFloat();
@@ -520,7 +565,9 @@ void mecademic::MecaAdapter::_processMonitoringReply(const QByteArray& reply) {
         case 2212: {
             auto list = msg.split(",");
             if (list.size() < 7) {
+                _parseErrorsMetric->increment();
                 qWarning(logMecaAdapter()) << "size error with 2212" << reply;
+                break;
             }
             for (int i = 0; i < 6; ++i) {
                 _currJointVel[i] = list[1 + i].toFloat();
@@ -530,7 +577,9 @@ void mecademic::MecaAdapter::_processMonitoringReply(const QByteArray& reply) {
         case 2214: {
             auto list = msg.split(",");
             if (list.size() < 7) {
+                _parseErrorsMetric->increment();
                 qWarning(logMecaAdapter()) << "size error with 2214" << reply;
+                break;
             }
             for (int i = 0; i < 6; ++i) {
                 _currTwist[i] = list[1 + i].toFloat();
@@ -593,6 +642,9 @@ void mecademic::MecaAdapter::_onMonitoringReadyRead() {
                 _processMonitoringReply(reply);
             }
         }
+        teleop::QueueMonitor::getInstance()
+            .getProbe(teleop::QueueLink::robotFeedback)
+            .post();
         emit feedback(_currPose, _currTwist);
     }
 }
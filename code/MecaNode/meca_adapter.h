@@ -1,13 +1,19 @@
 #ifndef MECA_ADAPTER_H
 #define MECA_ADAPTER_H
 
+#include "log_level.h"
 #include "logs.h"
+#include "metrics.h"
+#include "vec.h"
 
 #include <QLoggingCategory>
 #include <QSet>
 #include <QTcpSocket>
 
+#include <initializer_list>
+
 Q_DECLARE_LOGGING_CATEGORY(logMecaAdapter)
+TELEOP_LOG_MIN_LEVEL(logMecaAdapter, TELEOP_LOG_LEVEL)
 
 
 // ==========================================================================
@@ -56,7 +62,7 @@ class MecaAdapter : public QObject {
 
     // Defines the pose the TCP(TRF) w.r.t. the flange(FRF) in mm
     //   Raw command: SetTRF(x,y,z,r,p,w)
-    void setTCP(const QVector<float>& tcp);
+    void setTCP(const teleop::Vec6& tcp);
 
     // Limits the Cartesian Linear velocity of the TCP
     // Influence: MoveLin, MoveLinRelTRF, MoveLinRelWRF
@@ -126,21 +132,21 @@ class MecaAdapter : public QObject {
     //       j5 limits: min=  -115, max=  115  [degrees]
     //       j6 limits: min=-36000, max=36000  [degrees]
     //     Raw command: MoveJoints(j1,j2,j3,j4,j5,j6)
-    void moveJoints(const QVector<float>& joints);
+    void moveJoints(const teleop::Vec6& joints);
 
     // Linear Move of the TCP (TRF w.r.f WRF) [mm, degrees]
     //   Raw command: MoveLin(x,y,z,r,p,w)
-    void moveLin(const QVector<float>& pose);
+    void moveLin(const teleop::Vec6& pose);
 
     // Linear Move from the TCP (desired TRF w.r.f current TRF) [mm, degrees]
     //   Raw command: MoveLinRelTRF(x,y,z,r,p,w)
-    void moveLinRel(const QVector<float>& pose);
+    void moveLinRel(const teleop::Vec6& pose);
 
     // Joint Move of the TCP (TRF w.r.f WRF) [mm, degrees]
     // After the robot is homed, Monitoring Port transmits periodically data, at
     // the rate specified by the SetMonitoringInterval command
     //   Raw command: MovePose(x,y,z,r,p,w)
-    void movePose(const QVector<float>& pose);
+    void movePose(const teleop::Vec6& pose);
 
     // Sets the timeout after a velocity-mode motion command, after which all
     // joint speeds will be set to zero unless another velocity-mode motion
@@ -157,13 +163,13 @@ class MecaAdapter : public QObject {
     //       j5 limits: min=-300, max=300  [degrees/s]
     //       j6 limits: min=-300, max=300  [degrees/s]
     //     Raw command: MoveJointsVel(j1,j2,j3,j4,j5,j6)
-    void moveJointVel(const QVector<float>& jointsVel);
+    void moveJointVel(const teleop::Vec6& jointsVel);
 
     // Move robot with the specified Cartesian velocity
     //     Linear: min=-1000, max=1000  [mm/s]
     //    Angular: min=-300,  max=300   [degree/s]
     //   Raw command: MoveLinVelWRF(x,y,z,r,p,w)
-    void moveTwist(const QVector<float>& twist);
+    void moveTwist(const teleop::Vec6& twist);
 
     // Limits the velocity of the gripper fingers. max it's about 100 mm/s
     //          Linear: min=5, max=100, default=50  [%]
@@ -290,12 +296,19 @@ class MecaAdapter : public QObject {
     // get the list of checkpoints reached
     QSet<unsigned> getCheckpointReached();
 
-    MecaStatus     getRobotStatus() const;
-    QVector<float> getJoints() const;
-    QVector<float> getPose() const;
-    QVector<float> getJointVel() const;
-    QVector<float> getTwist() const;
-    unsigned       getTime() const;
+    MecaStatus   getRobotStatus() const;
+    teleop::Vec6 getJoints() const;
+    teleop::Vec6 getPose() const;
+    teleop::Vec6 getJointVel() const;
+    teleop::Vec6 getTwist() const;
+    unsigned     getTime() const;
+
+    // Write "name(arg0,arg1,...)\n" (or "name\n") to cmd, with
+    // commandDecimals digits and at most commandSize chars; return the size
+    static const int commandSize     = 256;
+    static const int commandDecimals = 4;
+    static int       formatCommand(char* cmd, const char* name,
+                                   std::initializer_list<double> args);
 
   private:
     // Connection
@@ -312,17 +325,27 @@ class MecaAdapter : public QObject {
     bool           _homed             = false;  // [2002][2003]
 
     // Current State from Monitoring
-    unsigned       _currTimeStamp = 0;                  // [2230]
-    MecaStatus     _currRobotStatus{};                  // [2007]
-    QVector<float> _currPose     = {0, 0, 0, 0, 0, 0};  // [2211]
-    QVector<float> _currTwist    = {0, 0, 0, 0, 0, 0};  // [2214]
-    QVector<float> _currJoints   = {0, 0, 0, 0, 0, 0};  // [2210]
-    QVector<float> _currJointVel = {0, 0, 0, 0, 0, 0};  // [2212]
+    unsigned     _currTimeStamp = 0;  // [2230]
+    MecaStatus   _currRobotStatus{};  // [2007]
+    teleop::Vec6 _currPose;           // [2211]
+    teleop::Vec6 _currTwist;          // [2214]
+    teleop::Vec6 _currJoints;         // [2210]
+    teleop::Vec6 _currJointVel;       // [2212]
 
     // Socket
     QByteArray _controlOverflow;
     QByteArray _monitoringOverflow;
 
+    // Metrics (MetricsRegistry)
+    teleop::MetricCounter* _commandsMetric;
+    teleop::MetricCounter* _commandErrorsMetric;
+    teleop::MetricCounter* _saturationsMetric;
+    teleop::MetricCounter* _framesMetric;
+    teleop::MetricCounter* _parseErrorsMetric;
+    teleop::MetricGauge*   _activatedMetric;
+    teleop::MetricGauge*   _homedMetric;
+    teleop::MetricGauge*   _errorMetric;
+
     // Enable the transmission of other real-time data over the monitoring port:
     // [2210] JointPos, [2211] CartPose, [2212] JointVel, [2214] Cartvel
     //     Raw command: SetRealTimeMonitoring(n1, n2, ...)
@@ -335,8 +358,10 @@ class MecaAdapter : public QObject {
     //     Raw command: SetRTC(t)
     void _setTime();
 
-    // Add newline character to cmd and sent it to the control socket
-    void _sendCommand(const QString& cmd);
+    // Send the formatCommand bytes to the control socket. The command is
+    // formatted on the stack, no allocation on the motion path.
+    void _sendCommand(const char*                   name,
+                      std::initializer_list<double> args = {});
 
     // Used to safely normalize the parameters to be sent to the Robot
     float _norm(float val, float min, float max);
@@ -358,7 +383,7 @@ class MecaAdapter : public QObject {
 
   signals:
     void abort();
-    void feedback(const QVector<float>& pose, const QVector<float>& twist);
+    void feedback(const teleop::Vec6& pose, const teleop::Vec6& twist);
 };
 
 }  // namespace mecademic
@@ -1,5 +1,10 @@
 #include "meca_node.h"
+#include "latency.h"
 #include "logs.h"
+#include "perf_counters.h"
+#include "queue_monitor.h"
+#include "sched_sampler.h"
+#include "trace.h"
 
 #include <QDebug>
 
@@ -8,8 +13,8 @@ Q_LOGGING_CATEGORY(logMecaNode, "MecaNode")
 
 // ==========================================================================
 teleop::MecaWorker::MecaWorker() {
-    qDebug(logMecaNode()) << QThread::currentThreadId()
-                          << " | MecaWorker::MecaWorker";
+    TELEOP_DEBUG(logMecaNode) << QThread::currentThreadId()
+                              << " | MecaWorker::MecaWorker";
     _meca      = new mecademic::MecaAdapter(this);
     _loopTimer = new QTimer(this);
     _loopTimer->setTimerType(Qt::TimerType::PreciseTimer);
@@ -17,10 +22,15 @@ teleop::MecaWorker::MecaWorker() {
     connect(this, &MecaWorker::finished, _loopTimer, &QTimer::stop);
     connect(_loopTimer, &QTimer::timeout, this, &MecaWorker::dutyCycle,
             Qt::DirectConnection);
+    connect(
+        _meca, &mecademic::MecaAdapter::abort, this,
+        []() { FlightRecorder::getInstance().dump("meca_abort"); },
+        Qt::DirectConnection);
     connect(_meca, &mecademic::MecaAdapter::abort, this, &MecaWorker::finished,
             Qt::DirectConnection);
     connect(_meca, &mecademic::MecaAdapter::feedback, this,
             &MecaWorker::onFeedback, Qt::QueuedConnection);
+    QueueMonitor::getInstance().getProbe(QueueLink::robotFeedback).enable();
 
     auto& settings         = SettingsManager::getInstance();
     _loopPeriod            = settings.getUnsigned("meca/period");
@@ -30,30 +40,40 @@ teleop::MecaWorker::MecaWorker() {
     _jointAcceleration     = settings.getFloat("meca/jointAcceleration");
     _velocityTimeout       = settings.getFloat("meca/velocityTimeout");
     _cartesianAcceleration = settings.getFloat("meca/cartesianAcceleration");
-    _tcp                   = settings.getQVector("task/fla_T_tcp");
-    _origin                = settings.getQVector("task/wsl_T_ori");
+    _tcp                   = settings.getVec6("task/fla_T_tcp");
+    _origin                = settings.getVec6("task/wsl_T_ori");
     _logEnabled            = settings.getBool("nodes/enable_logging_slave");
+    _cycleMonitor          = new CycleMonitor("MecaNode", _loopPeriod);
+    _stateMetric           = &MetricsRegistry::getInstance().getGauge(
+        "teleop_meca_state",
+        "State of the MecaNode (0: Init, 1: WaitForInit, 2: Start, "
+        "3: WaitForStart, 4: Teleop)");
 
     if (_logEnabled) {
         const unsigned log_size = settings.getUnsigned("nodes/log_size");
         // REQUEST POSE ABSOLUTE
-        auto req_poseAbs = new Logger("request_poseAbs", log_size, this);
+        auto req_poseAbs =
+            new Logger("request_poseAbs", LOG_UNITS_POSE, log_size, this);
         connect(this, &MecaWorker::logRequestPoseAbs, req_poseAbs,
                 &Logger::write, Qt::DirectConnection);
         // REQUEST POSE RELATIVE
-        auto req_poseRel = new Logger("request_poseRel", log_size, this);
+        auto req_poseRel =
+            new Logger("request_poseRel", LOG_UNITS_POSE, log_size, this);
         connect(this, &MecaWorker::logRequestPoseRel, req_poseRel,
                 &Logger::write, Qt::DirectConnection);
         // REQUEST TWIST
-        auto req_twist = new Logger("request_twist", log_size, this);
+        auto req_twist =
+            new Logger("request_twist", LOG_UNITS_TWIST, log_size, this);
         connect(this, &MecaWorker::logRequestTwist, req_twist, &Logger::write,
                 Qt::DirectConnection);
         // CURRENT POSE
-        auto cur_pose = new Logger("current_pose", log_size, this);
+        auto cur_pose =
+            new Logger("current_pose", LOG_UNITS_POSE, log_size, this);
         connect(this, &MecaWorker::logCurrentPose, cur_pose, &Logger::write,
                 Qt::DirectConnection);
         // CURRENT TWIST
-        auto cur_twist = new Logger("current_twist", log_size, this);
+        auto cur_twist =
+            new Logger("current_twist", LOG_UNITS_TWIST, log_size, this);
         connect(this, &MecaWorker::logCurrentTwist, cur_twist, &Logger::write,
                 Qt::DirectConnection);
     }
@@ -61,27 +81,39 @@ teleop::MecaWorker::MecaWorker() {
 
 
 teleop::MecaWorker::~MecaWorker() {
-    qDebug(logMecaNode()) << QThread::currentThreadId()
-                          << " | MecaWorker::~MecaWorker";
+    TELEOP_DEBUG(logMecaNode) << QThread::currentThreadId()
+                              << " | MecaWorker::~MecaWorker";
+    delete _cycleMonitor;
 }
 
 
 void teleop::MecaWorker::setRequest(const teleop::MecaRequestData& request) {
     _mutex.lock();
+    if (!_request.fired) {
+        QueueMonitor::getInstance()
+            .getProbe(QueueLink::robotRequest)
+            .coalesce();
+    }
     _request = request;
     _mutex.unlock();
 }
 
 
 void teleop::MecaWorker::onStart() {
-    qDebug(logMecaNode()) << QThread::currentThreadId()
-                          << " | MecaWorker::onStart";
+    TELEOP_DEBUG(logMecaNode) << QThread::currentThreadId()
+                              << " | MecaWorker::onStart";
+    Tracer::getInstance().setThreadName("MecaNode");
+    SchedSampler::getInstance().attach("MecaNode");
     _meca->initCommunication(_robotIP);
     _loopTimer->start(_loopPeriod);
 }
 
 
 void teleop::MecaWorker::dutyCycle() {
+    TELEOP_TRACE_SCOPE("MecaWorker::dutyCycle");
+    CycleScope cycle(*_cycleMonitor);
+    PerfScope  perf(PerfStage::mecaCycle);
+    _stateMetric->set(int(_state));
     switch (_state) {
         case MecaState::Init: {
             qInfo(logMecaNode()) << "MecaNode State: Init";
@@ -133,6 +165,7 @@ void teleop::MecaWorker::dutyCycle() {
             _mutex.unlock();
 
             if (!req.fired) {
+                TELEOP_TRACE_FLOW_END("sample", req.sample);
                 switch (req.mode) {
                     case Mode::vel:
                         _meca->moveTwist(req.twist);
@@ -144,6 +177,11 @@ void teleop::MecaWorker::dutyCycle() {
                         _meca->movePose(req.poseAbs);
                         break;
                 }
+                auto& latency = LatencyMonitor::getInstance();
+                latency.recordSince(LatencyStage::requestToCommand,
+                                    req.requested);
+                latency.recordSince(LatencyStage::touchToCommand, req.sample);
+                _waitingFeedback = req.sample;
                 if (_logEnabled) {
                     emit logRequestTwist(req.twist);
                     emit logRequestPoseRel(req.poseRel);
@@ -156,8 +194,13 @@ void teleop::MecaWorker::dutyCycle() {
 }
 
 
-void teleop::MecaWorker::onFeedback(const QVector<float>& pose,
-                                    const QVector<float>& twist) {
+void teleop::MecaWorker::onFeedback(const Vec6& pose, const Vec6& twist) {
+    QueueMonitor::getInstance().getProbe(QueueLink::robotFeedback).deliver();
+    if (_waitingFeedback != 0) {
+        LatencyMonitor::getInstance().recordSince(
+            LatencyStage::touchToFeedback, _waitingFeedback);
+        _waitingFeedback = 0;
+    }
     emit feedback(pose, twist);
     if (_logEnabled) {
         emit logCurrentPose(pose);
@@ -168,8 +211,8 @@ void teleop::MecaWorker::onFeedback(const QVector<float>& pose,
 
 // ==========================================================================
 teleop::MecaNode::MecaNode(QObject* parent) : QObject(parent) {
-    qDebug(logMecaNode()) << QThread::currentThreadId()
-                          << " | MecaNode::MecaNode";
+    TELEOP_DEBUG(logMecaNode) << QThread::currentThreadId()
+                              << " | MecaNode::MecaNode";
     _thread = new QThread(this);
     _worker = new MecaWorker();
 
@@ -183,29 +226,36 @@ teleop::MecaNode::MecaNode(QObject* parent) : QObject(parent) {
 
 
 teleop::MecaNode::~MecaNode() {
-    qDebug(logMecaNode()) << QThread::currentThreadId()
-                          << " | MecaNode::~MecaNode";
+    TELEOP_DEBUG(logMecaNode) << QThread::currentThreadId()
+                              << " | MecaNode::~MecaNode";
     _thread->quit();
     _thread->wait();
 }
 
 
 void teleop::MecaNode::onStart() {
-    qDebug(logMecaNode()) << QThread::currentThreadId() << " | MecaNode::start";
+    TELEOP_DEBUG(logMecaNode) << QThread::currentThreadId()
+                              << " | MecaNode::start";
     _worker->moveToThread(_thread);
     _thread->start(QThread::TimeCriticalPriority);
 }
 
 
-void teleop::MecaNode::onRequest(const QVector<float>& poseAbs,
-                                 const QVector<float>& poseRel,
-                                 const QVector<float>& twist,
-                                 const teleop::Mode&   mode) {
+void teleop::MecaNode::onRequest(const Vec6& poseAbs, const Vec6& poseRel,
+                                 const Vec6& twist, const teleop::Mode& mode,
+                                 quint64 sample) {
+    TELEOP_TRACE_SCOPE("MecaNode::onRequest");
+    TELEOP_TRACE_FLOW_STEP("sample", sample);
+    QueueMonitor::getInstance().getProbe(QueueLink::robotRequest).deliver();
+    LatencyMonitor::getInstance().recordSince(LatencyStage::touchToMecaNode,
+                                              sample);
     MecaRequestData data;
     data.fired   = false;
     data.poseAbs = poseAbs;
     data.poseRel = poseRel;
     data.twist   = twist;
     data.mode    = mode;
+    data.sample    = sample;
+    data.requested = LogClock::getInstance().getTicks();
     _worker->setRequest(data);
 }
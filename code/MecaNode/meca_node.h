@@ -1,8 +1,12 @@
 #ifndef MECA_NODE_H
 #define MECA_NODE_H
 
+#include "cycle_monitor.h"
+#include "log_level.h"
 #include "meca_adapter.h"
+#include "metrics.h"
 #include "settings.h"
+#include "vec.h"
 
 #include <QLoggingCategory>
 #include <QMutex>
@@ -11,6 +15,7 @@
 #include <QTimer>
 
 Q_DECLARE_LOGGING_CATEGORY(logMecaNode)
+TELEOP_LOG_MIN_LEVEL(logMecaNode, TELEOP_LOG_LEVEL)
 
 
 namespace teleop {
@@ -20,11 +25,13 @@ enum class MecaState { Init, WaitForInit, Start, WaitForStart, Teleop };
 
 // ==========================================================================
 struct MecaRequestData {
-    bool           fired   = true;
-    QVector<float> poseAbs = {0, 0, 0, 0, 0, 0};
-    QVector<float> poseRel = {0, 0, 0, 0, 0, 0};
-    QVector<float> twist   = {0, 0, 0, 0, 0, 0};
-    teleop::Mode   mode    = teleop::Mode::rel;
+    bool         fired = true;
+    Vec6         poseAbs;
+    Vec6         poseRel;
+    Vec6         twist;
+    teleop::Mode mode      = teleop::Mode::rel;
+    quint64      sample    = 0;  // LogClock stamp of the touch sample
+    quint64      requested = 0;  // LogClock stamp of MecaNode::onRequest
 };
 
 // ==========================================================================
@@ -40,37 +47,40 @@ class MecaWorker : public QObject {
     void setRequest(const MecaRequestData& request);
 
   private:
-    QTimer*                 _loopTimer = nullptr;
-    mecademic::MecaAdapter* _meca      = nullptr;
-    MecaState               _state     = MecaState::Init;
+    QTimer*                 _loopTimer       = nullptr;
+    CycleMonitor*           _cycleMonitor    = nullptr;
+    MetricGauge*            _stateMetric     = nullptr;
+    mecademic::MecaAdapter* _meca            = nullptr;
+    MecaState               _state           = MecaState::Init;
     QMutex                  _mutex;
     MecaRequestData         _request;
-
-    unsigned       _loopPeriod            = 500;
-    QString        _robotIP               = "192.168.0.100";
-    float          _blending              = 100;
-    float          _jointVelocity         = 25;
-    float          _jointAcceleration     = 100;
-    float          _velocityTimeout       = 0.05;
-    float          _cartesianAcceleration = 50;
-    QVector<float> _tcp;
-    QVector<float> _origin;
-    bool           _logEnabled = false;
+    quint64                 _waitingFeedback = 0;  // sample of last command
+
+    unsigned _loopPeriod            = 500;
+    QString  _robotIP               = "192.168.0.100";
+    float    _blending              = 100;
+    float    _jointVelocity         = 25;
+    float    _jointAcceleration     = 100;
+    float    _velocityTimeout       = 0.05;
+    float    _cartesianAcceleration = 50;
+    Vec6     _tcp;
+    Vec6     _origin;
+    bool     _logEnabled = false;
 
   signals:
     void finished();
-    void feedback(const QVector<float>& pose, const QVector<float>& twist);
+    void feedback(const teleop::Vec6& pose, const teleop::Vec6& twist);
     // logging
-    void logRequestPoseAbs(const QVector<float>& poseAbs);
-    void logRequestPoseRel(const QVector<float>& poseRel);
-    void logRequestTwist(const QVector<float>& twist);
-    void logCurrentPose(const QVector<float>& pose);
-    void logCurrentTwist(const QVector<float>& twist);
+    void logRequestPoseAbs(const teleop::Vec6& poseAbs);
+    void logRequestPoseRel(const teleop::Vec6& poseRel);
+    void logRequestTwist(const teleop::Vec6& twist);
+    void logCurrentPose(const teleop::Vec6& pose);
+    void logCurrentTwist(const teleop::Vec6& twist);
 
   public slots:
     void onStart();
     void dutyCycle();
-    void onFeedback(const QVector<float>& pose, const QVector<float>& twist);
+    void onFeedback(const teleop::Vec6& pose, const teleop::Vec6& twist);
 };
 
 // ==========================================================================
@@ -89,12 +99,13 @@ class MecaNode : public QObject {
 
   signals:
     void finished();
-    void feedback(const QVector<float>& pose, const QVector<float>& twist);
+    void feedback(const teleop::Vec6& pose, const teleop::Vec6& twist);
 
   public slots:
     void onStart();
-    void onRequest(const QVector<float>& poseAbs, const QVector<float>& poseRel,
-                   const QVector<float>& twist, const teleop::Mode& mode);
+    void onRequest(const teleop::Vec6& poseAbs, const teleop::Vec6& poseRel,
+                   const teleop::Vec6& twist, const teleop::Mode& mode,
+                   quint64 sample);
 };
 
 }  // namespace teleop
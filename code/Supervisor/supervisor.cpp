@@ -1,5 +1,9 @@
 #include "supervisor.h"
+#include "latency.h"
 #include "logs.h"
+#include "perf_counters.h"
+#include "queue_monitor.h"
+#include "trace.h"
 
 #include <QThread>
 
@@ -8,7 +12,7 @@ Q_LOGGING_CATEGORY(logSupervisor, "Supervisor")
 
 // ==========================================================================
 teleop::Supervisor::Supervisor(QObject* parent) : QObject(parent) {
-    qDebug(logSupervisor())
+    TELEOP_DEBUG(logSupervisor)
         << QThread::currentThreadId() << " | Supervisor::Supervisor";
     // LOG CLOCK
     connect(this, &Supervisor::started, this,
@@ -21,14 +25,23 @@ teleop::Supervisor::Supervisor(QObject* parent) : QObject(parent) {
     _logSize              = settings.getUnsigned("nodes/log_size");
     _taskMode             = settings.getMode("task/mode");
     _feedbackType         = settings.getFeedbackType("task/feedback_type");
-    _filterType           = settings.getFilterType("task/twist_filter_type");
+    _filterName           = settings.getQString("task/twist_filter_type");
+
+    auto& metrics   = MetricsRegistry::getInstance();
+    _requestsMetric = &metrics.getCounter("teleop_supervisor_requests_total",
+                                          "Requests of the joystick handled");
+    _robotRequestsMetric =
+        &metrics.getCounter("teleop_supervisor_robot_requests_total",
+                            "Requests forwarded to the robot");
+    _performMetric = &metrics.getGauge("teleop_supervisor_perform",
+                                       "Teleoperation button pressed (0 or 1)");
 
     qInfo(logSupervisor()) << "Task mode:    "
                            << convertModeToQString(_taskMode);
     qInfo(logSupervisor()) << "Feedback Type:"
                            << convertFeedbackTypeToQString(_feedbackType);
     qInfo(logSupervisor()) << "Twist Filter: "
-                           << convertFilterTypeToQString(_filterType);
+                           << _filterName;
 
     // MOTION GENERATOR
     _motionGenerator = new MotionGenerator(this);
@@ -55,40 +68,60 @@ teleop::Supervisor::Supervisor(QObject* parent) : QObject(parent) {
     }
 
     // FILTERS
-    _sma = new SimpleMovingAverage(settings.getFloat("filters/sma"), this);
-    _wma = new WeightedMovingAverage(settings.getFloat("filters/wma"), this);
-    _smm = new SimpleMovingMedian(settings.getFloat("filters/smm"), this);
-    _blp = new ButterworthLowPass(settings.getQVector("filters/blp"), this);
+    _filters = new FilterBank(_filterName, _enableLoggingFilters,
+                              settings.getBool("nodes/logging_filters_thread"),
+                              this);
 
-    auto log_master_twist = new Logger("master_twist", _logSize, this);
+    auto log_master_twist =
+        new Logger("master_twist", LOG_UNITS_TWIST, _logSize, this);
     connect(this, &Supervisor::logMasterTwist, log_master_twist, &Logger::write,
             Qt::DirectConnection);
 
     // LOGGING
     if (_enableLoggingFilters) {
-        auto log_abs = new Logger("filter_abs", _logSize, this);
+        auto log_abs =
+            new Logger("filter_abs", LOG_UNITS_POSE, _logSize, this);
         connect(this, &Supervisor::logABS, log_abs, &Logger::write,
                 Qt::DirectConnection);
-        auto log_rel = new Logger("filter_rel", _logSize, this);
+        auto log_rel =
+            new Logger("filter_rel", LOG_UNITS_POSE, _logSize, this);
         connect(this, &Supervisor::logREL, log_rel, &Logger::write,
                 Qt::DirectConnection);
-        auto log_eul = new Logger("filter_eul", _logSize, this);
+        auto log_eul =
+            new Logger("filter_eul", LOG_UNITS_TWIST, _logSize, this);
         connect(this, &Supervisor::logEUL, log_eul, &Logger::write,
                 Qt::DirectConnection);
-        auto log_sma = new Logger("filter_sma", _logSize, this);
-        connect(this, &Supervisor::logSMA, log_sma, &Logger::write,
+        auto log_sma =
+            new Logger("filter_sma", LOG_UNITS_TWIST, _logSize, this);
+        connect(_filters, &FilterBank::logSMA, log_sma, &Logger::write,
+                Qt::DirectConnection);
+        auto log_wma =
+            new Logger("filter_wma", LOG_UNITS_TWIST, _logSize, this);
+        connect(_filters, &FilterBank::logWMA, log_wma, &Logger::write,
+                Qt::DirectConnection);
+        auto log_smm =
+            new Logger("filter_smm", LOG_UNITS_TWIST, _logSize, this);
+        connect(_filters, &FilterBank::logSMM, log_smm, &Logger::write,
                 Qt::DirectConnection);
-        auto log_wma = new Logger("filter_wma", _logSize, this);
-        connect(this, &Supervisor::logWMA, log_wma, &Logger::write,
+        auto log_blp =
+            new Logger("filter_blp", LOG_UNITS_TWIST, _logSize, this);
+        connect(_filters, &FilterBank::logBLP, log_blp, &Logger::write,
                 Qt::DirectConnection);
-        auto log_smm = new Logger("filter_smm", _logSize, this);
-        connect(this, &Supervisor::logSMM, log_smm, &Logger::write,
+        auto log_smmblp =
+            new Logger("filter_smmblp", LOG_UNITS_TWIST, _logSize, this);
+        connect(_filters, &FilterBank::logSMMBLP, log_smmblp, &Logger::write,
                 Qt::DirectConnection);
-        auto log_blp = new Logger("filter_blp", _logSize, this);
-        connect(this, &Supervisor::logBLP, log_blp, &Logger::write,
+        auto log_sos =
+            new Logger("filter_sos", LOG_UNITS_TWIST, _logSize, this);
+        connect(_filters, &FilterBank::logSOS, log_sos, &Logger::write,
                 Qt::DirectConnection);
-        auto log_smmblp = new Logger("filter_smmblp", _logSize, this);
-        connect(this, &Supervisor::logSMMBLP, log_smmblp, &Logger::write,
+        auto log_kalman =
+            new Logger("filter_kalman", LOG_UNITS_TWIST, _logSize, this);
+        connect(_filters, &FilterBank::logKalman, log_kalman, &Logger::write,
+                Qt::DirectConnection);
+        auto log_abg =
+            new Logger("filter_abg", LOG_UNITS_TWIST, _logSize, this);
+        connect(_filters, &FilterBank::logABG, log_abg, &Logger::write,
                 Qt::DirectConnection);
     }
 
@@ -103,6 +136,9 @@ teleop::Supervisor::Supervisor(QObject* parent) : QObject(parent) {
                 &Supervisor::onJoystickRequest, Qt::QueuedConnection);
         connect(this, &Supervisor::feedbackForJoystick, joystick,
                 &TouchNode::onFeedback, Qt::QueuedConnection);
+        auto& queues = QueueMonitor::getInstance();
+        queues.getProbe(QueueLink::touchRequest).enable();
+        queues.getProbe(QueueLink::touchFeedback).enable();
         if (!_feedbackFromRobot) {
             connect(this, &Supervisor::controllerFeedback, this,
                     &Supervisor::onControllerFeedback, Qt::QueuedConnection);
@@ -118,6 +154,7 @@ teleop::Supervisor::Supervisor(QObject* parent) : QObject(parent) {
                 Qt::DirectConnection);
         connect(this, &Supervisor::requestForRobot, robot, &MecaNode::onRequest,
                 Qt::QueuedConnection);
+        QueueMonitor::getInstance().getProbe(QueueLink::robotRequest).enable();
         if (_feedbackFromRobot) {
             connect(robot, &MecaNode::feedback, this,
                     &Supervisor::onControllerFeedback, Qt::QueuedConnection);
@@ -127,20 +164,28 @@ teleop::Supervisor::Supervisor(QObject* parent) : QObject(parent) {
 
 
 teleop::Supervisor::~Supervisor() {
-    qDebug(logSupervisor())
+    TELEOP_DEBUG(logSupervisor)
         << QThread::currentThreadId() << " | Supervisor::~Supervisor";
 }
 
 
 void teleop::Supervisor::start() {
-    qDebug(logSupervisor())
+    TELEOP_DEBUG(logSupervisor)
         << QThread::currentThreadId() << " | Supervisor::start";
     emit started();
 }
 
 
 void teleop::Supervisor::onJoystickRequest(bool buttonDown, bool buttonUp,
-                                           const QMatrix4x4& wm_T_hip) {
+                                           const QMatrix4x4& wm_T_hip,
+                                           quint64           sample) {
+    TELEOP_TRACE_SCOPE("Supervisor::onJoystickRequest");
+    PerfScope perf(PerfStage::supervisorRequest);
+    TELEOP_TRACE_FLOW_STEP("sample", sample);
+    QueueMonitor::getInstance().getProbe(QueueLink::touchRequest).deliver();
+    LatencyMonitor::getInstance().recordSince(LatencyStage::touchToSupervisor,
+                                              sample);
+    _requestsMetric->increment();
     // get action
     const bool quit       = !buttonUp && buttonDown;
     const bool perform    = buttonUp;
@@ -149,74 +194,57 @@ void teleop::Supervisor::onJoystickRequest(bool buttonDown, bool buttonUp,
     _performFeedback      = false;
 
     if (quit) {
+        FlightRecorder::getInstance().dump("quit");
         emit finished();
     }
 
     if (perform) {
         _performFeedback = true;
         _motionGenerator->update(wm_T_hip, newRun);
-        auto           pose_absolute = _motionGenerator->getAbsolutePose();
-        auto           pose_relative = _motionGenerator->getRelativePose();
-        auto           raw_twist     = _motionGenerator->getTwist();
-        QVector<float> twist         = {0, 0, 0, 0, 0, 0};
-        switch (_filterType) {
-            case FilterType::none:
-                twist = raw_twist;
-                break;
-            case FilterType::sma:
-                twist = _sma->applyFilter(raw_twist);
-                break;
-            case FilterType::wma:
-                twist = _wma->applyFilter(raw_twist);
-                break;
-            case FilterType::smm:
-                twist = _smm->applyFilter(raw_twist);
-                break;
-            case FilterType::blp:
-                twist = _blp->applyFilter(raw_twist);
-                break;
-            case FilterType::smmblp:
-                twist = _blp->applyFilter(_smm->applyFilter(raw_twist));
-                break;
-        }
+        auto pose_absolute = _motionGenerator->getAbsolutePose();
+        auto pose_relative = _motionGenerator->getRelativePose();
+        auto raw_twist     = _motionGenerator->getTwist();
+        auto twist         = _filters->applyFilter(
+            raw_twist, pose_absolute, _motionGenerator->getTimeStep());
         emit logMasterTwist(twist);
 
         if (_taskMode == Mode::vel || _motionGenerator->isEnoughDistant()) {
+            QueueMonitor::getInstance()
+                .getProbe(QueueLink::robotRequest)
+                .post();
             emit requestForRobot(pose_absolute, pose_relative, twist,
-                                 _taskMode);
+                                 _taskMode, sample);
+            _robotRequestsMetric->increment();
             if (_enableLoggingFilters) {
                 emit logABS(pose_absolute);
                 emit logREL(pose_relative);
                 emit logEUL(raw_twist);
-                emit logSMA(_sma->applyFilter(raw_twist));
-                emit logWMA(_sma->applyFilter(raw_twist));
-                emit logSMM(_smm->applyFilter(raw_twist));
-                emit logBLP(_blp->applyFilter(raw_twist));
-                emit logSMMBLP(_blp->applyFilter(_smm->applyFilter(raw_twist)));
             }
         }
         emit controllerFeedback(pose_relative, twist);
 
-        //        qDebug(logSupervisor()) << "poseAbs:" << pose_absolute;
-        //        qDebug(logSupervisor()) << "PoseRel:" << pose_relative;
-        //        qDebug(logSupervisor()) << "Twist:  " << twist;
-        //        qDebug(logSupervisor()) << "-----------------";
+        //        TELEOP_DEBUG(logSupervisor) << "poseAbs:" << pose_absolute;
+        //        TELEOP_DEBUG(logSupervisor) << "PoseRel:" << pose_relative;
+        //        TELEOP_DEBUG(logSupervisor) << "Twist:  " << twist;
+        //        TELEOP_DEBUG(logSupervisor) << "-----------------";
     }
     if (reIndexing) {
         _motionGenerator->reIndexing();
         emit controllerFeedback({}, {});
     }
     _lastPerform = perform;  // update
+    _performMetric->set(perform);
 }
 
 
-void teleop::Supervisor::onControllerFeedback(const QVector<float>& pose,
-                                              const QVector<float>& twist) {
+void teleop::Supervisor::onControllerFeedback(const Vec6& pose,
+                                              const Vec6& twist) {
     if (_feedbackType != FeedbackType::none) {
+        QueueMonitor::getInstance().getProbe(QueueLink::touchFeedback).post();
         if (_performFeedback) {
             emit feedbackForJoystick(_forceGenerator->getForceFrom(pose));
         } else {
-            emit feedbackForJoystick({0, 0, 0, 0, 0, 0});
+            emit feedbackForJoystick(Vec6());
         }
     }
 }
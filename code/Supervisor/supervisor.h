@@ -1,9 +1,12 @@
 #ifndef SUPERVISOR_H
 #define SUPERVISOR_H
 
-#include "filters.h"
+#include "filter_bank.h"
 #include "generators.h"
+#include "log_level.h"
+#include "metrics.h"
 #include "settings.h"
+#include "vec.h"
 
 #include "meca_node.h"
 #include "touch_node.h"
@@ -14,6 +17,7 @@
 #include <QVector>
 
 Q_DECLARE_LOGGING_CATEGORY(logSupervisor)
+TELEOP_LOG_MIN_LEVEL(logSupervisor, TELEOP_LOG_LEVEL)
 Q_DECLARE_METATYPE(teleop::Mode)
 
 
@@ -33,10 +37,10 @@ class Supervisor : public QObject {
     SettingsPtr            _configs;
     MotionGenerator*       _motionGenerator;
     ForceGenerator*        _forceGenerator;
-    SimpleMovingAverage*   _sma;
-    WeightedMovingAverage* _wma;
-    SimpleMovingMedian*    _smm;
-    ButterworthLowPass*    _blp;
+    FilterBank*            _filters;
+    MetricCounter*         _requestsMetric;
+    MetricCounter*         _robotRequestsMetric;
+    MetricGauge*           _performMetric;
 
     bool         _performFeedback = false;
     bool         _lastPerform     = false;
@@ -45,34 +49,30 @@ class Supervisor : public QObject {
     bool         _enableLoggingFilters;
     Mode         _taskMode;
     FeedbackType _feedbackType;
-    FilterType   _filterType;
+    QString      _filterName;
 
   signals:
     void started();
     void finished();
-    void requestForRobot(const QVector<float>& poseAbs,
-                         const QVector<float>& poseRel,
-                         const QVector<float>& twist, const teleop::Mode& mode);
-    void feedbackForJoystick(const QVector<float>& wrench);
-    void controllerFeedback(const QVector<float>& pose,
-                            const QVector<float>& twist);
+    void requestForRobot(const teleop::Vec6& poseAbs,
+                         const teleop::Vec6& poseRel,
+                         const teleop::Vec6& twist, const teleop::Mode& mode,
+                         quint64 sample);
+    void feedbackForJoystick(const teleop::Vec6& wrench);
+    void controllerFeedback(const teleop::Vec6& pose,
+                            const teleop::Vec6& twist);
     void updateScalingFactor(float offset);
 
-    void logMasterTwist(const QVector<float>& twist);
-    void logABS(const QVector<float>& pose);
-    void logREL(const QVector<float>& pose);
-    void logEUL(const QVector<float>& twist);
-    void logSMA(const QVector<float>& twist);
-    void logWMA(const QVector<float>& twist);
-    void logSMM(const QVector<float>& twist);
-    void logBLP(const QVector<float>& twist);
-    void logSMMBLP(const QVector<float>& twist);
+    void logMasterTwist(const teleop::Vec6& twist);
+    void logABS(const teleop::Vec6& pose);
+    void logREL(const teleop::Vec6& pose);
+    void logEUL(const teleop::Vec6& twist);
 
   public slots:
     void onJoystickRequest(bool buttonDown, bool buttonUp,
-                           const QMatrix4x4& pose);
-    void onControllerFeedback(const QVector<float>& pose,
-                              const QVector<float>& twist);
+                           const QMatrix4x4& pose, quint64 sample);
+    void onControllerFeedback(const teleop::Vec6& pose,
+                              const teleop::Vec6& twist);
 };
 
 }  // namespace teleop
@@ -1,4 +1,6 @@
 #include "touch_adapter.h"
+#include "log_recorder.h"
+#include "logs.h"
 
 #include <QDebug>
 #include <QElapsedTimer>
@@ -66,6 +68,8 @@ void _checkHDErrors() {
             info.errorCode == HD_INVALID_PRIORITY ||
             info.errorCode == HD_SCHEDULER_FULL) {
             qCritical(logTouchAdapter()) << hdGetErrorString(info.errorCode);
+            // abort() ends the process here: dump the history first
+            teleop::FlightRecorder::getInstance().dump("touch_hd_error");
             emit abort();
         } else {
             qWarning(logTouchAdapter()) << hdGetErrorString(info.errorCode);
@@ -78,7 +82,7 @@ void _checkHDErrors() {
 
 // ==========================================================================
 systems3d::TouchAdapter::TouchAdapter(QObject* parent) : QObject(parent) {
-    qDebug(logTouchAdapter())
+    TELEOP_DEBUG(logTouchAdapter)
         << QThread::currentThreadId() << " | TouchAdapter::TouchAdapter";
 }
 
@@ -107,7 +111,7 @@ void systems3d::TouchAdapter::start() {
 
 
 systems3d::TouchAdapter::~TouchAdapter() {
-    qDebug(logTouchAdapter())
+    TELEOP_DEBUG(logTouchAdapter)
         << QThread::currentThreadId() << " | TouchAdapter::~TouchAdapter";
     // For cleanup, unschedule callbacks and stop the servo loop
     hdStopScheduler();
@@ -118,6 +122,7 @@ systems3d::TouchAdapter::~TouchAdapter() {
 void systems3d::TouchAdapter::updateState() {
     hdScheduleSynchronous(UpdateStateCallback, &_state,
                           HD_DEFAULT_SCHEDULER_PRIORITY);
+    _stamp = teleop::LogClock::getInstance().getTicks();
     _checkHDErrors();
 
     if (!_startupDone) {
@@ -130,6 +135,11 @@ void systems3d::TouchAdapter::updateState() {
 }
 
 
+quint64 systems3d::TouchAdapter::getStamp() {
+    return _stamp;
+}
+
+
 bool systems3d::TouchAdapter::getButtonDown() {
     return _state.buttonDown;
 }
@@ -169,7 +179,7 @@ QVector3D systems3d::TouchAdapter::getPosition() {
 //}
 
 
-void systems3d::TouchAdapter::setForce(const QVector<float>& force) {
+void systems3d::TouchAdapter::setForce(const teleop::Vec6& force) {
     if (_state.outsideInkwell) {
         HDfloat feedback[3] = {force[0], force[1], force[2]};
         hdScheduleSynchronous(ForceFeedbackCallback, &feedback,
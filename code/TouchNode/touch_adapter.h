@@ -1,6 +1,9 @@
 #ifndef TOUCH_ADAPTER_H
 #define TOUCH_ADAPTER_H
 
+#include "log_level.h"
+#include "vec.h"
+
 #include <HD/hd.h>
 #include <QLoggingCategory>
 #include <QMatrix4x4>
@@ -8,6 +11,7 @@
 #include <QVector3D>
 
 Q_DECLARE_LOGGING_CATEGORY(logTouchAdapter)
+TELEOP_LOG_MIN_LEVEL(logTouchAdapter, TELEOP_LOG_LEVEL)
 
 
 // ==========================================================================
@@ -38,17 +42,19 @@ class TouchAdapter : public QObject {
 
     void       start();
     void       updateState();
+    quint64    getStamp();  // LogClock ticks of the last updateState()
     bool       getButtonDown();
     bool       getButtonUp();
     QMatrix4x4 getPoseMatrix();
     QVector3D  getPosition();
     //    QVector3D  getVelocityLinear();
     //    QVector3D  getVelocityAngular();
-    void setForce(const QVector<float>& force);
+    void setForce(const teleop::Vec6& force);
 
   private:
     HHD        _device      = 0;
     TouchState _state       = {};
+    quint64    _stamp       = 0;
     bool       _startupDone = false;
 
   signals:
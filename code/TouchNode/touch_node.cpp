@@ -1,6 +1,10 @@
 #include "touch_node.h"
 #include "logs.h"
+#include "perf_counters.h"
+#include "queue_monitor.h"
+#include "sched_sampler.h"
 #include "settings.h"
+#include "trace.h"
 
 #include <QDebug>
 
@@ -9,8 +13,8 @@ Q_LOGGING_CATEGORY(logTouchNode, "TouchNode")
 
 // ==========================================================================
 teleop::TouchWorker::TouchWorker() {
-    qDebug(logTouchNode()) << QThread::currentThreadId()
-                           << " | TouchWorker::TouchWorker";
+    TELEOP_DEBUG(logTouchNode) << QThread::currentThreadId()
+                               << " | TouchWorker::TouchWorker";
     _touch     = new systems3d::TouchAdapter(this);
     _loopTimer = new QTimer(this);
     _loopTimer->setTimerType(Qt::TimerType::PreciseTimer);
@@ -18,6 +22,10 @@ teleop::TouchWorker::TouchWorker() {
     connect(this, &TouchWorker::finished, _loopTimer, &QTimer::stop);
     connect(_loopTimer, &QTimer::timeout, this, &TouchWorker::dutyCycle,
             Qt::DirectConnection);
+    connect(
+        _touch, &systems3d::TouchAdapter::abort, this,
+        []() { FlightRecorder::getInstance().dump("touch_abort"); },
+        Qt::DirectConnection);
     connect(_touch, &systems3d::TouchAdapter::abort, this,
             &TouchWorker::finished, Qt::DirectConnection);
 
@@ -25,10 +33,14 @@ teleop::TouchWorker::TouchWorker() {
     _loopPeriod      = settings.getUnsigned("touch/period");
     _feedbackEnabled = settings.getBool("touch/enable_feedback");
     _logEnabled      = settings.getBool("nodes/enable_logging_wrench");
+    _cycleMonitor    = new CycleMonitor("TouchNode", _loopPeriod);
+    _forceMetric     = &MetricsRegistry::getInstance().getCounter(
+        "teleop_touch_forces_total", "Forces applied to the haptic device");
 
     if (_logEnabled) {
-        const unsigned log_size   = settings.getUnsigned("nodes/log_size");
-        auto           log_wrench = new Logger("wrench", log_size, this);
+        const unsigned log_size = settings.getUnsigned("nodes/log_size");
+        auto           log_wrench =
+            new Logger("wrench", LOG_UNITS_WRENCH, log_size, this);
         connect(this, &TouchWorker::logWrench, log_wrench, &Logger::write,
                 Qt::DirectConnection);
     }
@@ -36,31 +48,40 @@ teleop::TouchWorker::TouchWorker() {
 
 
 teleop::TouchWorker::~TouchWorker() {
-    qDebug(logTouchNode()) << QThread::currentThreadId()
-                           << " | TouchWorker::~TouchWorker";
+    TELEOP_DEBUG(logTouchNode) << QThread::currentThreadId()
+                               << " | TouchWorker::~TouchWorker";
+    delete _cycleMonitor;
 }
 
 
 void teleop::TouchWorker::onStart() {
-    qDebug(logTouchNode()) << QThread::currentThreadId()
-                           << " | TouchWorker::start";
+    TELEOP_DEBUG(logTouchNode) << QThread::currentThreadId()
+                               << " | TouchWorker::start";
+    Tracer::getInstance().setThreadName("TouchNode");
+    SchedSampler::getInstance().attach("TouchNode");
     _touch->start();
     _loopTimer->start(_loopPeriod);
 }
 
 
 void teleop::TouchWorker::dutyCycle() {
+    TELEOP_TRACE_SCOPE("TouchWorker::dutyCycle");
+    CycleScope cycle(*_cycleMonitor);
+    PerfScope  perf(PerfStage::touchCycle);
     // REQUEST
     _touch->updateState();
     bool buttonDown  = _touch->getButtonDown();
     bool buttonUp    = _touch->getButtonUp();
     auto pose_matrix = _touch->getPoseMatrix();
-    emit request(buttonDown, buttonUp, pose_matrix);
+    auto sample      = _touch->getStamp();
+    TELEOP_TRACE_FLOW_BEGIN("sample", sample);
+    QueueMonitor::getInstance().getProbe(QueueLink::touchRequest).post();
+    emit request(buttonDown, buttonUp, pose_matrix, sample);
 
     // FEEDBACK
     if (_feedbackEnabled) {
-        bool           perform;
-        QVector<float> wrench = {0, 0, 0, 0, 0, 0};
+        bool perform;
+        Vec6 wrench;
         _mutex.lock();
         perform         = !_feedback.fired;
         wrench          = _feedback.wrench;
@@ -69,6 +90,7 @@ void teleop::TouchWorker::dutyCycle() {
 
         if (perform) {
             _touch->setForce(wrench);
+            _forceMetric->increment();
             //            qDebug() << wrench;
             if (_logEnabled) {
                 emit logWrench(wrench);
@@ -80,6 +102,11 @@ void teleop::TouchWorker::dutyCycle() {
 
 void teleop::TouchWorker::setFeedback(const TouchFeedbackData& feedback) {
     _mutex.lock();
+    if (!_feedback.fired) {
+        QueueMonitor::getInstance()
+            .getProbe(QueueLink::touchFeedback)
+            .coalesce();
+    }
     _feedback = feedback;
     _mutex.unlock();
 }
@@ -87,8 +114,8 @@ void teleop::TouchWorker::setFeedback(const TouchFeedbackData& feedback) {
 
 // ==========================================================================
 teleop::TouchNode::TouchNode(QObject* parent) : QObject(parent) {
-    qDebug(logTouchNode()) << QThread::currentThreadId()
-                           << " | TouchNode::TouchNode";
+    TELEOP_DEBUG(logTouchNode) << QThread::currentThreadId()
+                               << " | TouchNode::TouchNode";
     _thread = new QThread(this);
     _worker = new TouchWorker();
 
@@ -102,22 +129,23 @@ teleop::TouchNode::TouchNode(QObject* parent) : QObject(parent) {
 
 
 teleop::TouchNode::~TouchNode() {
-    qDebug(logTouchNode()) << QThread::currentThreadId()
-                           << " | TouchNode::~TouchNode";
+    TELEOP_DEBUG(logTouchNode) << QThread::currentThreadId()
+                               << " | TouchNode::~TouchNode";
     _thread->quit();
     _thread->wait();
 }
 
 
 void teleop::TouchNode::onStart() {
-    qDebug(logTouchNode()) << QThread::currentThreadId()
-                           << " | TouchNode::start";
+    TELEOP_DEBUG(logTouchNode) << QThread::currentThreadId()
+                               << " | TouchNode::start";
     _worker->moveToThread(_thread);
     _thread->start(QThread::TimeCriticalPriority);
 }
 
 
-void teleop::TouchNode::onFeedback(const QVector<float>& wrench) {
+void teleop::TouchNode::onFeedback(const Vec6& wrench) {
+    QueueMonitor::getInstance().getProbe(QueueLink::touchFeedback).deliver();
     TouchFeedbackData data;
     data.fired  = false;
     data.wrench = wrench;
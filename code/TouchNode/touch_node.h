@@ -1,7 +1,11 @@
 #ifndef TOUCH_NODE_H
 #define TOUCH_NODE_H
 
+#include "cycle_monitor.h"
+#include "log_level.h"
+#include "metrics.h"
 #include "touch_adapter.h"
+#include "vec.h"
 
 #include <QLoggingCategory>
 #include <QMutex>
@@ -10,16 +14,19 @@
 #include <QTimer>
 
 Q_DECLARE_LOGGING_CATEGORY(logTouchNode)
+TELEOP_LOG_MIN_LEVEL(logTouchNode, TELEOP_LOG_LEVEL)
 
 namespace teleop {
 
 // ==========================================================================
 struct TouchFeedbackData {
-    bool           fired  = true;
-    QVector<float> wrench = {0, 0, 0, 0, 0, 0};
+    bool fired = true;
+    Vec6 wrench;
 };
 
 // ==========================================================================
+// request(): sample is the LogClock stamp of the touch state, carried to the
+// robot command for the latency histograms and the trace flows.
 class TouchWorker : public QObject {
     Q_OBJECT
 
@@ -32,8 +39,10 @@ class TouchWorker : public QObject {
     void setFeedback(const TouchFeedbackData& feedback);
 
   private:
-    QTimer*                  _loopTimer = nullptr;
-    systems3d::TouchAdapter* _touch     = nullptr;
+    QTimer*                  _loopTimer    = nullptr;
+    CycleMonitor*            _cycleMonitor = nullptr;
+    MetricCounter*           _forceMetric  = nullptr;
+    systems3d::TouchAdapter* _touch        = nullptr;
     QMutex                   _mutex;
     TouchFeedbackData        _feedback;
 
@@ -44,9 +53,9 @@ class TouchWorker : public QObject {
   signals:
     void finished();
     void request(bool buttonDown, bool buttonUp,
-                 const QMatrix4x4& homogeneous_matrix);
+                 const QMatrix4x4& homogeneous_matrix, quint64 sample);
     // logging
-    void logWrench(const QVector<float>& wrench);
+    void logWrench(const teleop::Vec6& wrench);
 
   public slots:
     void onStart();
@@ -70,11 +79,11 @@ class TouchNode : public QObject {
   signals:
     void finished();
     void request(bool buttonDown, bool buttonUp,
-                 const QMatrix4x4& homogeneous_matrix);
+                 const QMatrix4x4& homogeneous_matrix, quint64 sample);
 
   public slots:
     void onStart();
-    void onFeedback(const QVector<float>& wrench);
+    void onFeedback(const teleop::Vec6& wrench);
 };
 
 }  // namespace teleop
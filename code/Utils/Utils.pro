@@ -1,4 +1,4 @@
-QT += core
+QT += core network
 
 TEMPLATE = lib
 
@@ -9,23 +9,69 @@ CONFIG(release, debug|release) {
     CONFIG += optimize_full
 }
 
+# The filters give bit-identical results with AVX, SSE or TELEOP_NO_SIMD
+# (lanes.h) only if no multiply-add is fused
+QMAKE_CXXFLAGS += -ffp-contract=off
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    cycle_monitor.cpp \
+    latency.cpp \
     logs.cpp \
+    log_codec.cpp \
+    log_format.cpp \
+    log_reader.cpp \
+    log_recorder.cpp \
+    log_segment.cpp \
+    log_session.cpp \
+    log_warning.cpp \
     kinematic.cpp \
+    metrics.cpp \
+    metrics_server.cpp \
+    number_format.cpp \
+    perf_counters.cpp \
+    queue_monitor.cpp \
     filters.cpp \
+    filter_bank.cpp \
+    filter_chain.cpp \
+    filter_design.cpp \
     generators.cpp \
-    settings.cpp
+    sched_sampler.cpp \
+    settings.cpp \
+    trace.cpp
 
 HEADERS += \
+    cycle_monitor.h \
+    latency.h \
     logs.h \
+    log_codec.h \
+    log_format.h \
+    log_level.h \
+    log_reader.h \
+    log_recorder.h \
+    log_segment.h \
+    log_session.h \
+    log_warning.h \
+    ring_buffer.h \
     kinematic.h \
+    lanes.h \
+    metrics.h \
+    metrics_server.h \
+    number_format.h \
+    perf_counters.h \
+    queue_monitor.h \
     filters.h \
+    filter_bank.h \
+    filter_chain.h \
+    filter_design.h \
     generators.h \
-    settings.h
+    sched_sampler.h \
+    settings.h \
+    trace.h \
+    vec.h
 
 # Default rules for deployment.
 unix {
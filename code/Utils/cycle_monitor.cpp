@@ -0,0 +1,229 @@
+#include "cycle_monitor.h"
+#include "logs.h"
+#include "settings.h"
+
+#include <QDebug>
+
+#include <cmath>
+#include <limits>
+
+
+// ==========================================================================
+teleop::CycleMonitor::CycleMonitor(const QString& name, unsigned period_ms)
+    : _name(name), _nominal(quint64(period_ms) * 1000000), _cycles(0),
+      _misses(0), _deviationSum(0), _deviationSumSq(0),
+      _periodMin(std::numeric_limits<quint64>::max()),
+      _period(name + " period"), _execution(name + " execution"),
+      _lateness(name + " lateness"),
+      _cyclesMetric(MetricsRegistry::getInstance().getCounter(
+          "teleop_cycles_total", "Cycles of the worker loop",
+          QString("loop=\"%1\"").arg(name))),
+      _missesMetric(MetricsRegistry::getInstance().getCounter(
+          "teleop_deadline_misses_total",
+          "Cycles of the worker loop ended after the next one was due",
+          QString("loop=\"%1\"").arg(name))),
+      _executionMetric(MetricsRegistry::getInstance().getHistogram(
+          "teleop_cycle_execution_seconds",
+          "Execution time of a cycle of the worker loop",
+          QString("loop=\"%1\"").arg(name))) {
+    CycleRegistry::getInstance().attach(this);
+}
+
+
+teleop::CycleMonitor::~CycleMonitor() {
+    CycleRegistry::getInstance().detach(this);
+    if (_cycles.load(std::memory_order_relaxed) > 0) {
+        qInfo(logLogger()).noquote() << getSummary();
+    }
+}
+
+
+void teleop::CycleMonitor::begin() {
+    const quint64 now = LogClock::getInstance().getNanoseconds();
+    if (_start == 0) {
+        _start    = now;  // first cycle: no period yet
+        _expected = now;
+        return;
+    }
+    const quint64 period = now - _start;
+    _start               = now;
+    _period.record(period);
+    quint64 min = _periodMin.load(std::memory_order_relaxed);
+    if (period < min) {
+        _periodMin.store(period, std::memory_order_relaxed);
+    }
+    const qint64 deviation = qint64(period) - qint64(_nominal);
+    _deviationSum.store(
+        _deviationSum.load(std::memory_order_relaxed) + deviation,
+        std::memory_order_relaxed);
+    _deviationSumSq.store(_deviationSumSq.load(std::memory_order_relaxed) +
+                              double(deviation) * deviation,
+                          std::memory_order_relaxed);
+
+    _expected += _nominal;
+    const quint64 lateness = now > _expected ? now - _expected : 0;
+    _lateness.record(lateness);
+    if (_nominal > 0 && lateness >= _nominal) {
+        // the timer skipped lateness / nominal ticks: restart the schedule
+        _misses.fetch_add(lateness / _nominal, std::memory_order_relaxed);
+        _missesMetric.increment(lateness / _nominal);
+        _expected = now;
+    }
+}
+
+
+void teleop::CycleMonitor::end() {
+    const quint64 now = LogClock::getInstance().getNanoseconds();
+    _execution.record(now - _start);
+    _executionMetric.record(now - _start);
+    if (now > _expected + _nominal) {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        _missesMetric.increment();
+    }
+    _cycles.fetch_add(1, std::memory_order_relaxed);
+    _cyclesMetric.increment();
+}
+
+
+const QString& teleop::CycleMonitor::getName() const {
+    return _name;
+}
+
+
+teleop::CycleMonitor::Snapshot teleop::CycleMonitor::getSnapshot() const {
+    Snapshot snapshot;
+    snapshot.name    = _name;
+    snapshot.nominal = _nominal;
+    snapshot.cycles  = _cycles.load(std::memory_order_relaxed);
+    snapshot.misses  = _misses.load(std::memory_order_relaxed);
+    // the first cycle has no period
+    const quint64 periods = _period.getCount();
+    const double  mean =
+        periods > 0
+            ? double(_deviationSum.load(std::memory_order_relaxed)) / periods
+            : 0;
+    const double square =
+        periods > 0
+            ? _deviationSumSq.load(std::memory_order_relaxed) / periods
+            : 0;
+    snapshot.periodMean   = _nominal + mean;
+    snapshot.periodStd    = std::sqrt(qMax(0.0, square - mean * mean));
+    snapshot.periodMin    =
+        periods > 0 ? _periodMin.load(std::memory_order_relaxed) : 0;
+    snapshot.periodMax    = _period.getMax();
+    snapshot.executionP50 = _execution.getPercentile(50);
+    snapshot.executionP99 = _execution.getPercentile(99);
+    snapshot.executionMax = _execution.getMax();
+    snapshot.latenessP99  = _lateness.getPercentile(99);
+    snapshot.latenessMax  = _lateness.getMax();
+    return snapshot;
+}
+
+
+QString teleop::CycleMonitor::getSummary() const {
+    const auto s     = getSnapshot();
+    const auto ratio = s.cycles > 0 ? 100.0 * s.misses / s.cycles : 0.0;
+    return QString("%1: n=%2 period=%3us mean=%4us std=%5us min=%6us "
+                   "max=%7us | exec p50=%8us p99=%9us max=%10us | "
+                   "late p99=%11us max=%12us | misses=%13 (%14%)")
+        .arg(s.name)
+        .arg(s.cycles)
+        .arg(s.nominal * 1e-3, 0, 'f', 0)
+        .arg(s.periodMean * 1e-3, 0, 'f', 1)
+        .arg(s.periodStd * 1e-3, 0, 'f', 1)
+        .arg(s.periodMin * 1e-3, 0, 'f', 1)
+        .arg(s.periodMax * 1e-3, 0, 'f', 1)
+        .arg(s.executionP50 * 1e-3, 0, 'f', 1)
+        .arg(s.executionP99 * 1e-3, 0, 'f', 1)
+        .arg(s.executionMax * 1e-3, 0, 'f', 1)
+        .arg(s.latenessP99 * 1e-3, 0, 'f', 1)
+        .arg(s.latenessMax * 1e-3, 0, 'f', 1)
+        .arg(s.misses)
+        .arg(ratio, 0, 'f', 3);
+}
+
+
+const teleop::LatencyHistogram&
+teleop::CycleMonitor::getPeriodHistogram() const {
+    return _period;
+}
+
+
+const teleop::LatencyHistogram&
+teleop::CycleMonitor::getExecutionHistogram() const {
+    return _execution;
+}
+
+
+const teleop::LatencyHistogram&
+teleop::CycleMonitor::getLatenessHistogram() const {
+    return _lateness;
+}
+
+
+// ==========================================================================
+teleop::CycleScope::CycleScope(CycleMonitor& monitor) : _monitor(monitor) {
+    _monitor.begin();
+}
+
+
+teleop::CycleScope::~CycleScope() {
+    _monitor.end();
+}
+
+
+// ==========================================================================
+teleop::CycleRegistry& teleop::CycleRegistry::getInstance() {
+    static CycleRegistry instance;
+    return instance;
+}
+
+
+teleop::CycleRegistry::CycleRegistry() {
+    _period = SettingsManager::getInstance().getUnsigned(
+        "nodes/cycle_report_period");
+    _timer.start();
+}
+
+
+void teleop::CycleRegistry::attach(CycleMonitor* monitor) {
+    _mutex.lock();
+    _monitors.append(monitor);
+    _mutex.unlock();
+}
+
+
+void teleop::CycleRegistry::detach(CycleMonitor* monitor) {
+    _mutex.lock();
+    _monitors.removeAll(monitor);
+    _mutex.unlock();
+}
+
+
+QVector<teleop::CycleMonitor::Snapshot> teleop::CycleRegistry::getSnapshots() {
+    QVector<CycleMonitor::Snapshot> snapshots;
+    _mutex.lock();
+    for (auto monitor : _monitors) {
+        snapshots.append(monitor->getSnapshot());
+    }
+    _mutex.unlock();
+    return snapshots;
+}
+
+
+void teleop::CycleRegistry::poll() {
+    if (_period == 0 || _timer.elapsed() < _period) {
+        return;
+    }
+    _timer.restart();
+    report();
+}
+
+
+void teleop::CycleRegistry::report() {
+    _mutex.lock();
+    for (auto monitor : _monitors) {
+        qInfo(logLogger()).noquote() << monitor->getSummary();
+    }
+    _mutex.unlock();
+}
@@ -0,0 +1,126 @@
+#ifndef CYCLE_MONITOR_H
+#define CYCLE_MONITOR_H
+
+#include "latency.h"
+#include "metrics.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+
+namespace teleop {
+
+// ==========================================================================
+// Timing of a periodic worker (e.g. the dutyCycle of a QTimer): for every
+// cycle begin() and end() record
+// - period:    time between two consecutive begin()
+// - execution: time between begin() and end()
+// - lateness:  delay of begin() on its schedule (previous one + period)
+// A deadline is missed when a cycle ends after the next one is due; ticks
+// skipped by the timer count as missed too, and the schedule is restarted
+// from the late cycle (like a QTimer::PreciseTimer does).
+// begin()/end() belong to the worker thread: they only store atomics and
+// never allocate, getSnapshot() can be called from any thread. The cycles,
+// the misses and the execution time are exported as metrics too, labelled
+// with the name (loop="...").
+class CycleMonitor {
+  public:
+    struct Snapshot {
+        QString name;
+        quint64 nominal;  // [ns]
+        quint64 cycles;
+        quint64 misses;
+        double  periodMean;  // [ns]
+        double  periodStd;   // [ns]
+        quint64 periodMin;   // [ns]
+        quint64 periodMax;   // [ns]
+        quint64 executionP50;
+        quint64 executionP99;
+        quint64 executionMax;
+        quint64 latenessP99;
+        quint64 latenessMax;
+    };
+
+    CycleMonitor(const QString& name, unsigned period_ms);
+    CycleMonitor(const CycleMonitor&) = delete;
+    CycleMonitor(CycleMonitor&&)      = delete;
+    ~CycleMonitor();  // logs the summary
+
+    void begin();
+    void end();
+
+    const QString&          getName() const;
+    Snapshot                getSnapshot() const;
+    QString                 getSummary() const;
+    const LatencyHistogram& getPeriodHistogram() const;
+    const LatencyHistogram& getExecutionHistogram() const;
+    const LatencyHistogram& getLatenessHistogram() const;
+
+  private:
+    const QString _name;
+    const quint64 _nominal;  // [ns]
+    // worker thread only
+    quint64 _start    = 0;  // [ns] of the current cycle
+    quint64 _expected = 0;  // [ns] schedule of the current cycle
+    // shared
+    std::atomic<quint64> _cycles;
+    std::atomic<quint64> _misses;
+    std::atomic<qint64>  _deviationSum;    // [ns] of period - nominal
+    std::atomic<double>  _deviationSumSq;  // [ns^2]
+    std::atomic<quint64> _periodMin;
+    LatencyHistogram     _period;
+    LatencyHistogram     _execution;
+    LatencyHistogram     _lateness;
+    MetricCounter&       _cyclesMetric;
+    MetricCounter&       _missesMetric;
+    LatencyHistogram&    _executionMetric;
+};
+
+// ==========================================================================
+// RAII begin()/end() of a cycle:
+//     void Worker::dutyCycle() {
+//         CycleScope cycle(*_cycleMonitor);
+class CycleScope {
+  public:
+    explicit CycleScope(CycleMonitor& monitor);
+    ~CycleScope();
+    CycleScope(const CycleScope&) = delete;
+    void operator=(const CycleScope&) = delete;
+
+  private:
+    CycleMonitor& _monitor;
+};
+
+// ==========================================================================
+// Every live CycleMonitor, reported every nodes/cycle_report_period ms by
+// the LogWriter thread
+class CycleRegistry {  // singleton
+  public:
+    static CycleRegistry& getInstance();
+
+    void attach(CycleMonitor* monitor);
+    void detach(CycleMonitor* monitor);
+
+    QVector<CycleMonitor::Snapshot> getSnapshots();
+    void                            poll();  // LogWriter thread
+    void                            report();
+
+  private:
+    QMutex                 _mutex;
+    QVector<CycleMonitor*> _monitors;
+    QElapsedTimer          _timer;
+    qint64                 _period = 0;  // [ms], 0 = never
+
+    CycleRegistry();
+    CycleRegistry(const CycleRegistry&) = delete;
+    void operator=(const CycleRegistry&) = delete;
+};
+
+}  // namespace teleop
+
+
+#endif  // CYCLE_MONITOR_H
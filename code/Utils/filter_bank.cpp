@@ -0,0 +1,208 @@
+#include "filter_bank.h"
+#include "filter_design.h"
+#include "sched_sampler.h"
+#include "settings.h"
+#include "trace.h"
+
+#include <QDebug>
+
+Q_LOGGING_CATEGORY(logFilterBank, "FilterBank")
+
+
+// ==========================================================================
+namespace {
+
+struct BankEntry {
+    teleop::FilterType type;
+    unsigned           outputs;  // the selected one and what it depends on
+    teleop::Vec6 teleop::FilterBankSample::*selected;
+};
+
+
+const BankEntry BANK_ENTRIES[] = {
+    {teleop::FilterType::none, 0, &teleop::FilterBankSample::raw},
+    {teleop::FilterType::sma, teleop::FilterBank::sma,
+     &teleop::FilterBankSample::sma},
+    {teleop::FilterType::wma, teleop::FilterBank::wma,
+     &teleop::FilterBankSample::wma},
+    {teleop::FilterType::smm, teleop::FilterBank::smm,
+     &teleop::FilterBankSample::smm},
+    {teleop::FilterType::blp, teleop::FilterBank::blp,
+     &teleop::FilterBankSample::blp},
+    {teleop::FilterType::smmblp,
+     teleop::FilterBank::smm | teleop::FilterBank::smmblp,
+     &teleop::FilterBankSample::smmblp},
+    {teleop::FilterType::sos, teleop::FilterBank::sos,
+     &teleop::FilterBankSample::sos},
+    {teleop::FilterType::kalman, teleop::FilterBank::kalman,
+     &teleop::FilterBankSample::kalman},
+    {teleop::FilterType::abg, teleop::FilterBank::abg,
+     &teleop::FilterBankSample::abg},
+};
+
+}  // namespace
+
+
+// ==========================================================================
+teleop::FilterBankWorker::FilterBankWorker(unsigned outputs, QObject* parent)
+    : QObject(parent) {
+    auto& settings = SettingsManager::getInstance();
+    if (outputs & FilterBank::sma) {
+        _sma =
+            new SimpleMovingAverage(settings.getFloat("filters/sma"), this);
+    }
+    if (outputs & FilterBank::wma) {
+        _wma =
+            new WeightedMovingAverage(settings.getFloat("filters/wma"), this);
+    }
+    if (outputs & FilterBank::smm) {
+        _smm = new SimpleMovingMedian(settings.getFloat("filters/smm"), this);
+    }
+    if (outputs & FilterBank::blp) {
+        _blp = new ButterworthLowPass(settings.getQVector("filters/blp"),
+                                      this);
+    }
+    if (outputs & FilterBank::smmblp) {
+        _smmblp = new ButterworthLowPass(settings.getQVector("filters/blp"),
+                                         this);
+    }
+    if (outputs & FilterBank::sos) {
+        _sos = new BiquadCascade(designTwistLowPass(), this);
+    }
+    if (outputs & FilterBank::kalman) {
+        _kalman =
+            new KalmanEstimator(settings.getVec6("filters/kalman_noise"),
+                                settings.getVec6("filters/kalman_jerk"), this);
+    }
+    if (outputs & FilterBank::abg) {
+        _abg = new AlphaBetaGammaEstimator(
+            settings.getFloat("filters/abg_theta"), this);
+    }
+}
+
+
+void teleop::FilterBankWorker::evaluate(FilterBankSample& sample) {
+    // smm before smmblp, which reads it (from this worker or the other one)
+    if (_sma) {
+        sample.sma = _sma->applyFilter(sample.raw);
+    }
+    if (_wma) {
+        sample.wma = _wma->applyFilter(sample.raw);
+    }
+    if (_smm) {
+        sample.smm = _smm->applyFilter(sample.raw);
+    }
+    if (_blp) {
+        sample.blp = _blp->applyFilter(sample.raw);
+    }
+    if (_smmblp) {
+        sample.smmblp = _smmblp->applyFilter(sample.smm);
+    }
+    if (_sos) {
+        sample.sos = _sos->applyFilter(sample.raw);
+    }
+    if (_kalman) {
+        sample.kalman = _kalman->update(sample.pose, sample.step);
+    }
+    if (_abg) {
+        sample.abg = _abg->update(sample.pose, sample.step);
+    }
+}
+
+
+void teleop::FilterBankWorker::onStart() {
+    Tracer::getInstance().setThreadName("FilterBank");
+    SchedSampler::getInstance().attach("FilterBank");
+}
+
+
+void teleop::FilterBankWorker::onSample(const FilterBankSample& sample) {
+    TELEOP_TRACE_SCOPE("FilterBankWorker::onSample");
+    FilterBankSample result = sample;
+    evaluate(result);
+    emit evaluated(result);
+}
+
+
+// ==========================================================================
+teleop::FilterBank::FilterBank(const QString& name, bool logging,
+                               bool loggingThread, QObject* parent)
+    : QObject(parent) {
+    unsigned control = 0;
+    bool     inBank  = false;
+    for (const BankEntry& entry : BANK_ENTRIES) {
+        if (name == convertFilterTypeToQString(entry.type)) {
+            control   = entry.outputs;
+            _selected = entry.selected;
+            inBank    = true;
+        }
+    }
+    if (!inBank) {
+        _chain = FilterChainRegistry::getInstance().create(name, this);
+    }
+    if (control) {
+        _control = new FilterBankWorker(control, this);
+    }
+    if (!logging) {
+        return;
+    }
+
+    const unsigned rest = all & ~control;
+    if (!loggingThread) {
+        _logging = new FilterBankWorker(rest, this);
+        return;
+    }
+    // the worker lives in the thread, the log signals are emitted there
+    _thread  = new QThread(this);
+    _logging = new FilterBankWorker(rest);
+    _logging->moveToThread(_thread);
+    connect(_thread, &QThread::started, _logging, &FilterBankWorker::onStart);
+    connect(_thread, &QThread::finished, _logging,
+            &FilterBankWorker::deleteLater);
+    connect(this, &FilterBank::sampleForLogging, _logging,
+            &FilterBankWorker::onSample, Qt::QueuedConnection);
+    connect(_logging, &FilterBankWorker::evaluated, this,
+            &FilterBank::onEvaluated, Qt::DirectConnection);
+    _thread->start(QThread::LowPriority);
+    qInfo(logFilterBank()) << "Logging filters on their own thread";
+}
+
+
+teleop::FilterBank::~FilterBank() {
+    if (_thread) {
+        _thread->quit();
+        _thread->wait();
+    }
+}
+
+
+teleop::Vec6 teleop::FilterBank::applyFilter(const Vec6& raw,
+                                             const Vec6& pose, float step) {
+    FilterBankSample sample;
+    sample.pose = pose;
+    sample.step = step;
+    sample.raw  = raw;
+    if (_control) {
+        _control->evaluate(sample);
+    }
+    const Vec6 twist = _chain ? _chain->applyFilter(raw) : sample.*_selected;
+    if (_thread) {
+        emit sampleForLogging(sample);
+    } else if (_logging) {
+        _logging->evaluate(sample);
+        onEvaluated(sample);
+    }
+    return twist;
+}
+
+
+void teleop::FilterBank::onEvaluated(const FilterBankSample& sample) {
+    emit logSMA(sample.sma);
+    emit logWMA(sample.wma);
+    emit logSMM(sample.smm);
+    emit logBLP(sample.blp);
+    emit logSMMBLP(sample.smmblp);
+    emit logSOS(sample.sos);
+    emit logKalman(sample.kalman);
+    emit logABG(sample.abg);
+}
@@ -0,0 +1,123 @@
+#ifndef FILTER_BANK_H
+#define FILTER_BANK_H
+
+#include "filter_chain.h"
+#include "filters.h"
+#include "vec.h"
+
+#include <QLoggingCategory>
+#include <QObject>
+#include <QThread>
+
+Q_DECLARE_LOGGING_CATEGORY(logFilterBank)
+
+
+namespace teleop {
+
+// ==========================================================================
+// Outputs of the bank filters for one sample of the raw twist, the
+// estimators use the pose it comes from
+struct FilterBankSample {
+    Vec6  pose;
+    float step = 0;  // [s] since the previous pose, 0 to restart
+    Vec6  raw;
+    Vec6  sma;
+    Vec6  wma;
+    Vec6  smm;
+    Vec6  blp;
+    Vec6  smmblp;  // the blp of the smm output
+    Vec6  sos;
+    Vec6  kalman;
+    Vec6  abg;
+};
+
+// ==========================================================================
+// Owns a subset of the bank filters (FilterBank::Output flags) and fills
+// their outputs. Each filter belongs to one worker, so it is touched by one
+// thread and sees every sample once.
+class FilterBankWorker : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit FilterBankWorker(unsigned outputs, QObject* parent = nullptr);
+
+    void evaluate(FilterBankSample& sample);
+
+  private:
+    SimpleMovingAverage*     _sma    = nullptr;
+    WeightedMovingAverage*   _wma    = nullptr;
+    SimpleMovingMedian*      _smm    = nullptr;
+    ButterworthLowPass*      _blp    = nullptr;
+    ButterworthLowPass*      _smmblp = nullptr;
+    BiquadCascade*           _sos    = nullptr;
+    KalmanEstimator*         _kalman = nullptr;
+    AlphaBetaGammaEstimator* _abg    = nullptr;
+
+  signals:
+    void evaluated(const teleop::FilterBankSample& sample);
+
+  public slots:
+    void onStart();
+    void onSample(const teleop::FilterBankSample& sample);
+};
+
+// ==========================================================================
+// Twist filters of the Supervisor, each evaluated once per sample. The
+// FilterType names of task/twist_filter_type select an output of the bank,
+// the other chains of FilterChainRegistry run beside it. With logging, the
+// log signals carry every output of the sample; with a logging thread
+// (nodes/logging_filters_thread) the filters that only feed the logs run
+// there and the control thread evaluates just the selected one.
+class FilterBank : public QObject {
+    Q_OBJECT
+
+  public:
+    enum Output : unsigned {
+        sma    = 1 << 0,
+        wma    = 1 << 1,
+        smm    = 1 << 2,
+        blp    = 1 << 3,
+        smmblp = 1 << 4,
+        sos    = 1 << 5,
+        kalman = 1 << 6,
+        abg    = 1 << 7,
+        all    = (1 << 8) - 1
+    };
+
+    FilterBank(const QString& name, bool logging, bool loggingThread,
+               QObject* parent = nullptr);
+    FilterBank(const FilterBank&) = delete;
+    FilterBank(FilterBank&&)      = delete;
+    ~FilterBank();
+
+    // control thread; pose and step for the estimators
+    Vec6 applyFilter(const Vec6& raw, const Vec6& pose, float step);
+
+  private:
+    Vec6 FilterBankSample::*_selected = &FilterBankSample::raw;
+    TwistFilter*            _chain    = nullptr;  // not a bank output
+    FilterBankWorker*       _control  = nullptr;
+    FilterBankWorker*       _logging  = nullptr;
+    QThread*                _thread   = nullptr;
+
+  signals:
+    void logSMA(const teleop::Vec6& twist);
+    void logWMA(const teleop::Vec6& twist);
+    void logSMM(const teleop::Vec6& twist);
+    void logBLP(const teleop::Vec6& twist);
+    void logSMMBLP(const teleop::Vec6& twist);
+    void logSOS(const teleop::Vec6& twist);
+    void logKalman(const teleop::Vec6& twist);
+    void logABG(const teleop::Vec6& twist);
+    void sampleForLogging(const teleop::FilterBankSample& sample);
+
+  private slots:
+    void onEvaluated(const teleop::FilterBankSample& sample);
+};
+
+}  // namespace teleop
+
+Q_DECLARE_METATYPE(teleop::FilterBankSample)
+
+
+#endif  // FILTER_BANK_H
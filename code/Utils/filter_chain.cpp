@@ -0,0 +1,94 @@
+#include "filter_chain.h"
+#include "filter_design.h"
+#include "settings.h"
+
+#include <QDebug>
+
+Q_LOGGING_CATEGORY(logFilterChain, "FilterChain")
+
+
+// ==========================================================================
+teleop::TwistFilter::TwistFilter(QObject* parent) : QObject(parent) {
+}
+
+
+// ==========================================================================
+teleop::SmaStage::SmaStage()
+    : filter(SettingsManager::getInstance().getFloat("filters/sma")) {
+}
+
+
+teleop::WmaStage::WmaStage()
+    : filter(SettingsManager::getInstance().getFloat("filters/wma")) {
+}
+
+
+teleop::SmmStage::SmmStage()
+    : filter(SettingsManager::getInstance().getFloat("filters/smm")) {
+}
+
+
+teleop::BlpStage::BlpStage()
+    : filter(SettingsManager::getInstance().getQVector("filters/blp")) {
+}
+
+
+teleop::SosStage::SosStage() : SosStage(designTwistLowPass()) {
+}
+
+
+teleop::SosStage::SosStage(const QVector<Biquad>& sections)
+    : filter(sections) {
+    qInfo(logFilterChain()).noquote() << "SOS:" << describeBiquads(sections);
+}
+
+
+teleop::DeadbandStage::DeadbandStage()
+    : filter(SettingsManager::getInstance().getVec6("filters/deadband")) {
+}
+
+
+// ==========================================================================
+teleop::FilterChainRegistry& teleop::FilterChainRegistry::getInstance() {
+    static FilterChainRegistry instance;
+    return instance;
+}
+
+
+teleop::FilterChainRegistry::FilterChainRegistry() {
+    // one stage per FilterType
+    add<>(convertFilterTypeToQString(FilterType::none));
+    add<SmaStage>(convertFilterTypeToQString(FilterType::sma));
+    add<WmaStage>(convertFilterTypeToQString(FilterType::wma));
+    add<SmmStage>(convertFilterTypeToQString(FilterType::smm));
+    add<BlpStage>(convertFilterTypeToQString(FilterType::blp));
+    add<SmmStage, BlpStage>(convertFilterTypeToQString(FilterType::smmblp));
+    add<SosStage>(convertFilterTypeToQString(FilterType::sos));
+    // combinations
+    add<SmmStage, SosStage>("smmsos");
+    add<SosStage, DeadbandStage>("sosdb");
+    add<SmmStage, SosStage, DeadbandStage>("smmsosdb");
+}
+
+
+bool teleop::FilterChainRegistry::contains(const QString& name) const {
+    return _factories.contains(name);
+}
+
+
+QStringList teleop::FilterChainRegistry::getNames() const {
+    return _factories.keys();
+}
+
+
+teleop::TwistFilter*
+teleop::FilterChainRegistry::create(const QString& name,
+                                    QObject*       parent) const {
+    if (!_factories.contains(name)) {
+        qCritical(logFilterChain())
+            << "Unknown twist filter" << name << "in" << getNames();
+        qCritical(logFilterChain()) << "FATAL";
+        exit(EXIT_FAILURE);
+    }
+    return _factories.value(name)(parent);
+}
@@ -0,0 +1,168 @@
+#ifndef FILTER_CHAIN_H
+#define FILTER_CHAIN_H
+
+#include "filters.h"
+#include "vec.h"
+
+#include <QLoggingCategory>
+#include <QMap>
+#include <QObject>
+#include <QStringList>
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+Q_DECLARE_LOGGING_CATEGORY(logFilterChain)
+
+
+namespace teleop {
+
+// ==========================================================================
+// Filter of the twist requests. The chains below implement it: one virtual
+// call per sample, the stages are called directly.
+class TwistFilter : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit TwistFilter(QObject* parent = nullptr);
+    virtual Vec6 applyFilter(const Vec6& data) = 0;
+};
+
+// ==========================================================================
+// Stages of the chains: default constructible from the [filters] settings,
+// with a non-virtual apply()
+struct SmaStage {
+    SimpleMovingAverage filter;
+    SmaStage();
+    Vec6 apply(const Vec6& data) { return filter.applyFilter(data); }
+};
+
+struct WmaStage {
+    WeightedMovingAverage filter;
+    WmaStage();
+    Vec6 apply(const Vec6& data) { return filter.applyFilter(data); }
+};
+
+struct SmmStage {
+    SimpleMovingMedian filter;
+    SmmStage();
+    Vec6 apply(const Vec6& data) { return filter.applyFilter(data); }
+};
+
+struct BlpStage {
+    ButterworthLowPass filter;
+    BlpStage();
+    Vec6 apply(const Vec6& data) { return filter.applyFilter(data); }
+};
+
+struct SosStage {  // filters/sos_* at the touch rate
+    BiquadCascade filter;
+    SosStage();
+    explicit SosStage(const QVector<Biquad>& sections);
+    Vec6 apply(const Vec6& data) { return filter.applyFilter(data); }
+};
+
+struct DeadbandStage {  // filters/deadband, one threshold per component
+    Deadband filter;
+    DeadbandStage();
+    Vec6 apply(const Vec6& data) { return filter.applyFilter(data); }
+};
+
+// ==========================================================================
+// Stages applied in order, e.g. FilterChain<SmmStage, SosStage>: the
+// stages are members and the recursion is resolved at compile time, so a
+// sample goes through the chain without virtual calls or temporaries on
+// the heap. FilterChain<> passes the data through.
+template <typename... Stages>
+class FilterChain : public TwistFilter {
+  public:
+    explicit FilterChain(QObject* parent = nullptr);
+    Vec6 applyFilter(const Vec6& data) override;
+
+  private:
+    std::tuple<Stages...> _stages;
+
+    template <std::size_t I>
+    typename std::enable_if<(I == sizeof...(Stages)), Vec6>::type
+    _apply(const Vec6& data);
+    template <std::size_t I>
+    typename std::enable_if<(I < sizeof...(Stages)), Vec6>::type
+    _apply(const Vec6& data);
+};
+
+// ==========================================================================
+// Twist filters by name (task/twist_filter_type). The built-in chains are
+// the FilterType names plus the combinations registered in the
+// constructor; a new combination is one add() there. The estimators
+// (kalman, abg) take the poses, not the twist: FilterBank runs them.
+class FilterChainRegistry {  // singleton
+  public:
+    static FilterChainRegistry& getInstance();
+
+    template <typename... Stages>
+    void add(const QString& name);
+
+    bool         contains(const QString& name) const;
+    QStringList  getNames() const;
+    TwistFilter* create(const QString& name,  // exits if unknown
+                        QObject*       parent = nullptr) const;
+
+  private:
+    using Factory = TwistFilter* (*)(QObject*);
+
+    QMap<QString, Factory> _factories;
+
+    FilterChainRegistry();
+    FilterChainRegistry(const FilterChainRegistry&) = delete;
+    void operator=(const FilterChainRegistry&) = delete;
+
+    template <typename... Stages>
+    static TwistFilter* _create(QObject* parent);
+};
+
+
+// ==========================================================================
+template <typename... Stages>
+FilterChain<Stages...>::FilterChain(QObject* parent) : TwistFilter(parent) {
+}
+
+
+template <typename... Stages>
+Vec6 FilterChain<Stages...>::applyFilter(const Vec6& data) {
+    return _apply<0>(data);
+}
+
+
+template <typename... Stages>
+template <std::size_t I>
+typename std::enable_if<(I == sizeof...(Stages)), Vec6>::type
+FilterChain<Stages...>::_apply(const Vec6& data) {
+    return data;
+}
+
+
+template <typename... Stages>
+template <std::size_t I>
+typename std::enable_if<(I < sizeof...(Stages)), Vec6>::type
+FilterChain<Stages...>::_apply(const Vec6& data) {
+    return _apply<I + 1>(std::get<I>(_stages).apply(data));
+}
+
+
+// ==========================================================================
+template <typename... Stages>
+void FilterChainRegistry::add(const QString& name) {
+    _factories.insert(name, &FilterChainRegistry::_create<Stages...>);
+}
+
+
+template <typename... Stages>
+TwistFilter* FilterChainRegistry::_create(QObject* parent) {
+    return new FilterChain<Stages...>(parent);
+}
+
+}  // namespace teleop
+
+
+#endif  // FILTER_CHAIN_H
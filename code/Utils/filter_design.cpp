@@ -0,0 +1,217 @@
+#include "filter_design.h"
+
+#include <QDebug>
+#include <QStringList>
+#include <QtMath>
+
+#include <algorithm>
+#include <complex>
+
+Q_LOGGING_CATEGORY(logFilterDesign, "FilterDesign")
+
+
+// ==========================================================================
+namespace {
+
+using Complex = std::complex<double>;
+
+const int MAX_ORDER = 12;
+
+
+[[noreturn]] void fail(const QString& message) {
+    qCritical(logFilterDesign).noquote() << message;
+    qCritical(logFilterDesign) << "FATAL";
+    exit(EXIT_FAILURE);
+}
+
+
+// poles of the analog prototypes, -3 dB (end of the ripple) at 1 rad/s
+QVector<Complex> butterworthPoles(int order) {
+    QVector<Complex> poles;
+    for (int k = 0; k < order; ++k) {
+        const double theta = M_PI * (2 * k + order + 1) / (2.0 * order);
+        poles.append(std::polar(1.0, theta));
+    }
+    return poles;
+}
+
+
+QVector<Complex> chebyshevPoles(int order, double ripple) {
+    const double epsilon = qSqrt(qPow(10, ripple / 10) - 1);
+    const double mu      = std::asinh(1 / epsilon) / order;
+    QVector<Complex> poles;
+    for (int k = 0; k < order; ++k) {
+        const double theta = M_PI * (2 * k + 1) / (2.0 * order);
+        poles.append(Complex(-std::sinh(mu) * qSin(theta),
+                             std::cosh(mu) * qCos(theta)));
+    }
+    return poles;
+}
+
+
+double magnitude(const QVector<Complex>& poles, double omega) {
+    // |H(j omega)| of the all-pole prototype with unit gain at DC
+    double result = 1;
+    for (const Complex& pole : poles) {
+        result *= std::abs(pole) / std::abs(Complex(0, omega) - pole);
+    }
+    return result;
+}
+
+
+QVector<Complex> besselPoles(int order) {
+    // roots of the reverse Bessel polynomial (Durand-Kerner), monic with
+    // a_k = (2n - k)! / (2^(n - k) k! (n - k)!)
+    QVector<double> coefficients(order + 1);
+    for (int k = 0; k <= order; ++k) {
+        coefficients[k] = std::tgamma(2 * order - k + 1) /
+                          (qPow(2, order - k) * std::tgamma(k + 1) *
+                           std::tgamma(order - k + 1));
+    }
+    auto evaluate = [&](const Complex& s) {
+        Complex result = 0;
+        for (int k = order; k >= 0; --k) {
+            result = result * s + coefficients[k];
+        }
+        return result;
+    };
+    QVector<Complex> poles;
+    const double     radius = order;  // the roots lie around |s| ~ n
+    for (int k = 0; k < order; ++k) {
+        poles.append(std::polar(radius, 0.4 + 2 * M_PI * k / order));
+    }
+    for (int iteration = 0; iteration < 1000; ++iteration) {
+        double change = 0;
+        for (int k = 0; k < order; ++k) {
+            Complex denominator = 1;
+            for (int j = 0; j < order; ++j) {
+                if (j != k) {
+                    denominator *= poles[k] - poles[j];
+                }
+            }
+            const Complex step = evaluate(poles[k]) / denominator;
+            poles[k] -= step;
+            change = qMax(change, std::abs(step) / std::abs(poles[k]));
+        }
+        if (change < 1e-14) {
+            break;
+        }
+    }
+    // from unit group delay to -3 dB at 1 rad/s
+    double low  = 0;
+    double high = 1;
+    while (magnitude(poles, high) > M_SQRT1_2) {
+        high *= 2;
+    }
+    for (int iteration = 0; iteration < 100; ++iteration) {
+        const double middle = (low + high) / 2;
+        (magnitude(poles, middle) > M_SQRT1_2 ? low : high) = middle;
+    }
+    for (Complex& pole : poles) {
+        pole /= high;
+    }
+    return poles;
+}
+
+}  // namespace
+
+
+// ==========================================================================
+QVector<teleop::Biquad> teleop::designLowPass(FilterDesign design, int order,
+                                              double cutoff, double sampleRate,
+                                              double ripple) {
+    if (order < 1 || order > MAX_ORDER) {
+        fail(QString("order %1 not in [1, %2]").arg(order).arg(MAX_ORDER));
+    }
+    if (!(sampleRate > 0) || !(cutoff > 0) || !(cutoff < sampleRate / 2)) {
+        fail(QString("cutoff %1 Hz not in (0, %2) Hz")
+                 .arg(cutoff)
+                 .arg(sampleRate / 2));
+    }
+    if (design == FilterDesign::chebyshev && !(ripple > 0)) {
+        fail(QString("Chebyshev ripple %1 dB not positive").arg(ripple));
+    }
+
+    QVector<Complex> poles;
+    switch (design) {
+        case FilterDesign::butterworth:
+            poles = butterworthPoles(order);
+            break;
+        case FilterDesign::bessel:
+            poles = besselPoles(order);
+            break;
+        case FilterDesign::chebyshev:
+            poles = chebyshevPoles(order, ripple);
+            break;
+    }
+
+    // prewarped cutoff, bilinear transform s = 2 fs (z - 1) / (z + 1): the
+    // zeros at infinity go to z = -1
+    const double fs2    = 2 * sampleRate;
+    const double warped = fs2 * qTan(M_PI * cutoff / sampleRate);
+    QVector<Complex> pairs;  // one of each conjugate pair
+    QVector<double>  reals;
+    for (const Complex& pole : poles) {
+        const Complex zPole = (fs2 + pole * warped) / (fs2 - pole * warped);
+        if (qAbs(zPole.imag()) < 1e-9) {
+            reals.append(zPole.real());
+        } else if (zPole.imag() > 0) {
+            pairs.append(zPole);
+        }
+    }
+    if (2 * pairs.size() + reals.size() != order) {
+        fail(QString("%1 poles paired out of %2")
+                 .arg(2 * pairs.size() + reals.size())
+                 .arg(order));
+    }
+    std::sort(pairs.begin(), pairs.end(),
+              [](const Complex& a, const Complex& b) {
+                  return std::abs(a) < std::abs(b);
+              });
+
+    QVector<Biquad> sections;
+    for (double zPole : reals) {
+        Biquad section;
+        section.a1     = -zPole;
+        const double g = (1 + section.a1) / 2;  // unit gain at z = 1
+        section.b0     = g;
+        section.b1     = g;
+        sections.append(section);
+    }
+    for (const Complex& zPole : pairs) {
+        Biquad section;
+        section.a1     = -2 * zPole.real();
+        section.a2     = std::norm(zPole);
+        const double g = (1 + section.a1 + section.a2) / 4;
+        section.b0     = g;
+        section.b1     = 2 * g;
+        section.b2     = g;
+        sections.append(section);
+    }
+    return sections;
+}
+
+
+QVector<teleop::Biquad> teleop::designTwistLowPass() {
+    // the twist requests come at the rate of the touch loop
+    auto& settings = SettingsManager::getInstance();
+    return designLowPass(settings.getFilterDesign("filters/sos_design"),
+                         settings.getUnsigned("filters/sos_order"),
+                         settings.getFloat("filters/sos_cutoff"),
+                         1000.0 / settings.getFloat("touch/period"),
+                         settings.getFloat("filters/sos_ripple"));
+}
+
+
+QString teleop::describeBiquads(const QVector<Biquad>& sections) {
+    QStringList rows;
+    for (const Biquad& section : sections) {
+        rows.append(QString("[%1, %2, %3 | 1, %4, %5]")
+                        .arg(section.b0, 0, 'g', 9)
+                        .arg(section.b1, 0, 'g', 9)
+                        .arg(section.b2, 0, 'g', 9)
+                        .arg(section.a1, 0, 'g', 9)
+                        .arg(section.a2, 0, 'g', 9));
+    }
+    return rows.join(" ");
+}
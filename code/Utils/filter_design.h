@@ -0,0 +1,46 @@
+#ifndef FILTER_DESIGN_H
+#define FILTER_DESIGN_H
+
+#include "settings.h"
+
+#include <QLoggingCategory>
+#include <QString>
+#include <QVector>
+
+Q_DECLARE_LOGGING_CATEGORY(logFilterDesign)
+
+
+namespace teleop {
+
+// ==========================================================================
+// Coefficients of one second-order section, a0 normalized to 1:
+//   H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+// A first-order section has b2 = a2 = 0.
+struct Biquad {
+    double b0 = 1;
+    double b1 = 0;
+    double b2 = 0;
+    double a1 = 0;
+    double a2 = 0;
+};
+
+// ==========================================================================
+// Digital low pass of the given order (1..12) as second-order sections:
+// analog prototype, cutoff prewarped, bilinear transform. One section per
+// pair of complex poles (plus a first-order one when the order is odd),
+// the least resonant first, each with unit gain at DC.
+// cutoff and sampleRate in [Hz], cutoff below the Nyquist frequency.
+// Butterworth and Bessel are -3 dB at the cutoff; Chebyshev (type I) has a
+// ripple of `ripple` dB up to the cutoff (above the DC gain with an even
+// order). Exits on invalid parameters.
+QVector<Biquad> designLowPass(FilterDesign design, int order, double cutoff,
+                              double sampleRate, double ripple = 1.0);
+
+QVector<Biquad> designTwistLowPass();  // filters/sos_* at the touch rate
+
+QString describeBiquads(const QVector<Biquad>& sections);  // for the logs
+
+}  // namespace teleop
+
+
+#endif  // FILTER_DESIGN_H
@@ -1,124 +1,254 @@
 #include "filters.h"
+#include "lanes.h"
+
+#include <QtMath>
 
 #include <algorithm>
+#include <cmath>
 
 
 // --------------------------------------------------------------------------
 // SIMPLE MOVING AVERAGE
 teleop::SimpleMovingAverage::SimpleMovingAverage(int window, QObject* parent)
-    : QObject(parent), _window(window) {
+    : QObject(parent), _window(qMax(1, window)), _memory(_window) {
 }
 
 
-QVector<float>
-teleop::SimpleMovingAverage::applyFilter(const QVector<float>& data) {
-    if (_memory.size() < _window) {
+teleop::Vec6 teleop::SimpleMovingAverage::applyFilter(const Vec6& data) {
+    const Lanes x      = Lanes::load(data);
+    Lanes       result = Lanes::load(_result);
+    if (_count < _window) {
         // cumulative moving average
-        _memory.enqueue(data);
-        int n = _memory.size();
-        for (int i = 0; i < 6; ++i) {
-            _result[i] = (data[i] + n * _result[i]) / (n + 1);
-        }
+        _memory[_count++] = data;
+        const float n     = _count;
+        result            = (x + n * result) / (n + 1);
     } else {
         // simple moving average
-        auto tail = _memory.dequeue();
-        _memory.enqueue(data);
-        for (int i = 0; i < 6; ++i) {
-            _result[i] += (data[i] - tail[i]) / _window;
-        }
+        const Lanes tail = Lanes::load(_memory[_next]);
+        _memory[_next]   = data;
+        _next            = (_next + 1) % _window;
+        result           = result + (x - tail) / float(_window);
     }
+    result.store(_result);
     return _result;
 }
 
+
+QVector<teleop::Vec6>
+teleop::SimpleMovingAverage::applyBatch(const QVector<Vec6>& data) {
+    QVector<Vec6> result(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        result[i] = applyFilter(data[i]);
+    }
+    return result;
+}
+
 // --------------------------------------------------------------------------
 // WEIGHTED MOVING AVERAGE
 teleop::WeightedMovingAverage::WeightedMovingAverage(int      window,
                                                      QObject* parent)
-    : QObject(parent), _window(window) {
+    : QObject(parent), _window(qMax(1, window)), _memory(_window) {
 }
 
 
-QVector<float>
-teleop::WeightedMovingAverage::applyFilter(const QVector<float>& data) {
-    if (_memory.size() < _window) {
+teleop::Vec6 teleop::WeightedMovingAverage::applyFilter(const Vec6& data) {
+    const Lanes x         = Lanes::load(data);
+    Lanes       numerator = Lanes::load(_numerator);
+    Lanes       total     = Lanes::load(_total);
+    if (_count < _window) {
         // cumulative moving average
-        _memory.enqueue(data);
-        int weight = _memory.size();
+        _memory[_count++]  = data;
+        const float weight = _count;
         _denominator += weight;
-        for (int i = 0; i < 6; ++i) {
-            _numerator[i] += weight * data[i];
-            _total[i] += data[i];
-        }
-
+        numerator = numerator + weight * x;
+        total     = total + x;
     } else {
         // weighted moving average
-        auto tail = _memory.dequeue();
-        _memory.enqueue(data);
-        for (int i = 0; i < 6; ++i) {
-            // Note: this _total is total_n, while the next line _total is
-            // total_n+1. So DON'T change order
-            _numerator[i] += _window * data[i] - _total[i];
-            _total[i] += data[i] - tail[i];
+        const Lanes tail = Lanes::load(_memory[_next]);
+        _memory[_next]   = data;
+        _next            = (_next + 1) % _window;
+        // Note: this total is total_n, while the next line total is
+        // total_n+1. So DON'T change order
+        numerator = numerator + (float(_window) * x - total);
+        total     = total + (x - tail);
+    }
+    numerator.store(_numerator);
+    total.store(_total);
+    Vec6 result;
+    (numerator / _denominator).store(result);
+    return result;
+}
+
+
+QVector<teleop::Vec6>
+teleop::WeightedMovingAverage::applyBatch(const QVector<Vec6>& data) {
+    QVector<Vec6> result(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        result[i] = applyFilter(data[i]);
+    }
+    return result;
+}
+
+
+// --------------------------------------------------------------------------
+// SLIDING MEDIAN
+teleop::SlidingMedian::SlidingMedian(int window)
+    : _window(qMax(1, window)), _values(_window, 0), _positions(_window),
+      _heap(_window) {
+    // the k-th value pushed takes the heap positions 0, -1, 1, -2, 2, ...
+    for (int k = 0; k < _window; ++k) {
+        _positions[k] = (k + 1) / 2 * (k % 2 == 1 ? -1 : 1);
+        _at(_positions[k]) = k;
+    }
+}
+
+
+void teleop::SlidingMedian::push(float value) {
+    const bool  warmUp   = _count < _window;
+    const int   position = _positions[_next];
+    const float old      = _values[_next];
+    _values[_next]       = value;
+    _next                = (_next + 1) % _window;
+    _count += warmUp;
+    if (position > 0) {
+        // upper half
+        if (!warmUp && old < value) {
+            _minSortDown(position * 2);
+        } else if (_minSortUp(position)) {
+            _maxSortDown(-1);
+        }
+    } else if (position < 0) {
+        // lower half
+        if (!warmUp && value < old) {
+            _maxSortDown(position * 2);
+        } else if (_maxSortUp(position)) {
+            _minSortDown(1);
+        }
+    } else {
+        // the median itself
+        if (_maxCount() > 0) {
+            _maxSortDown(-1);
+        }
+        if (_minCount() > 0) {
+            _minSortDown(1);
         }
     }
-    // clang-format off
-    return {_numerator[0] / _denominator,
-            _numerator[1] / _denominator,
-            _numerator[2] / _denominator,
-            _numerator[3] / _denominator,
-            _numerator[4] / _denominator,
-            _numerator[5] / _denominator};
-    // clang-format on
+}
+
+
+float teleop::SlidingMedian::getMedian() const {
+    return _values[_heap[_window / 2]];
+}
+
+
+int teleop::SlidingMedian::getCount() const {
+    return _count;
+}
+
+
+int& teleop::SlidingMedian::_at(int position) {
+    return _heap[position + _window / 2];
+}
+
+
+bool teleop::SlidingMedian::_less(int i, int j) {
+    return _values[_at(i)] < _values[_at(j)];
+}
+
+
+bool teleop::SlidingMedian::_exchangeIfLess(int i, int j) {
+    if (!_less(i, j)) {
+        return false;
+    }
+    std::swap(_at(i), _at(j));
+    _positions[_at(i)] = i;
+    _positions[_at(j)] = j;
+    return true;
+}
+
+
+int teleop::SlidingMedian::_minCount() const {
+    return (_count - 1) / 2;
+}
+
+
+int teleop::SlidingMedian::_maxCount() const {
+    return _count / 2;
+}
+
+
+void teleop::SlidingMedian::_minSortDown(int i) {
+    // from i to the leaves, i / 2 being its parent (0: the median). The
+    // children of i are 2i and 2i + 1
+    for (; i <= _minCount(); i *= 2) {
+        if (i > 1 && i < _minCount() && _less(i + 1, i)) {
+            ++i;
+        }
+        if (!_exchangeIfLess(i, i / 2)) {
+            break;
+        }
+    }
+}
+
+
+void teleop::SlidingMedian::_maxSortDown(int i) {
+    // same on the negative side: the children of i are 2i and 2i - 1
+    for (; i >= -_maxCount(); i *= 2) {
+        if (i < -1 && i > -_maxCount() && _less(i, i - 1)) {
+            --i;
+        }
+        if (!_exchangeIfLess(i / 2, i)) {
+            break;
+        }
+    }
+}
+
+
+bool teleop::SlidingMedian::_minSortUp(int i) {
+    // true when the value reached the median
+    while (i > 0 && _exchangeIfLess(i, i / 2)) {
+        i /= 2;
+    }
+    return i == 0;
+}
+
+
+bool teleop::SlidingMedian::_maxSortUp(int i) {
+    while (i < 0 && _exchangeIfLess(i / 2, i)) {
+        i /= 2;
+    }
+    return i == 0;
 }
 
 
 // --------------------------------------------------------------------------
 // SIMPLE MOVING MEDIAN
 teleop::SimpleMovingMedian::SimpleMovingMedian(int window, QObject* parent)
-    : QObject(parent), _window(window) {
-    _bufferX.resize(_window);
-    _bufferY.resize(_window);
-    _bufferZ.resize(_window);
-    _bufferR.resize(_window);
-    _bufferP.resize(_window);
-    _bufferW.resize(_window);
+    : QObject(parent) {
+    _medians.reserve(6);
+    for (int i = 0; i < 6; ++i) {
+        _medians.append(SlidingMedian(window));
+    }
 }
 
 
-QVector<float>
-teleop::SimpleMovingMedian::applyFilter(const QVector<float>& data) {
-    // Insertion phase
-    if (_memory.size() < _window) {
-        _memory.enqueue(data);
-    } else {
-        _memory.dequeue();
-        _memory.enqueue(data);
-    }
-    for (int i = 0; i < _memory.size(); ++i) {
-        _bufferX[i] = _memory[i][0];
-        _bufferY[i] = _memory[i][1];
-        _bufferZ[i] = _memory[i][2];
-        _bufferR[i] = _memory[i][3];
-        _bufferP[i] = _memory[i][4];
-        _bufferW[i] = _memory[i][5];
-    }
-    // Sorting phase
-    std::sort(_bufferX.begin(), _bufferX.end());
-    std::sort(_bufferY.begin(), _bufferY.end());
-    std::sort(_bufferZ.begin(), _bufferZ.end());
-    std::sort(_bufferR.begin(), _bufferR.end());
-    std::sort(_bufferP.begin(), _bufferP.end());
-    std::sort(_bufferW.begin(), _bufferW.end());
-    // clang-format off
-        return {
-            _bufferX[_window / 2],
-            _bufferY[_window / 2],
-            _bufferZ[_window / 2],
-            _bufferR[_window / 2],
-            _bufferP[_window / 2],
-            _bufferW[_window / 2],
-        };
-    // clang-format on
+teleop::Vec6 teleop::SimpleMovingMedian::applyFilter(const Vec6& data) {
+    Vec6 result;
+    for (int i = 0; i < 6; ++i) {
+        _medians[i].push(data[i]);
+        result[i] = _medians[i].getMedian();
+    }
+    return result;
+}
+
+
+QVector<teleop::Vec6>
+teleop::SimpleMovingMedian::applyBatch(const QVector<Vec6>& data) {
+    QVector<Vec6> result(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        result[i] = applyFilter(data[i]);
+    }
+    return result;
 }
 
 
@@ -138,18 +268,262 @@ teleop::ButterworthLowPass::ButterworthLowPass(const QVector<float>& parameters,
 }
 
 
-QVector<float>
-teleop::ButterworthLowPass::applyFilter(const QVector<float>& data) {
+teleop::Vec6 teleop::ButterworthLowPass::applyFilter(const Vec6& data) {
     // Get current
-    QVector<float> y0 = {0, 0, 0, 0, 0, 0};
-    for (int i = 0; i < 6; i++) {
-        y0[i] = _a0 * _y1[i] + _a1 * _y2[i] + _b0 * data[i] + _b1 * _x1[i] +
-                _b2 * _x2[i];
-    }
+    const Lanes y0 = _a0 * Lanes::load(_y1) + _a1 * Lanes::load(_y2) +
+                     _b0 * Lanes::load(data) + _b1 * Lanes::load(_x1) +
+                     _b2 * Lanes::load(_x2);
     // Update memory
     _y2 = _y1;
-    _y1 = y0;
+    y0.store(_y1);
     _x2 = _x1;
     _x1 = data;
-    return y0;
+    return _y1;
+}
+
+
+QVector<teleop::Vec6>
+teleop::ButterworthLowPass::applyBatch(const QVector<Vec6>& data) {
+    // the memory stays in registers along the whole column
+    QVector<Vec6> result(data.size());
+    Lanes         x1 = Lanes::load(_x1);
+    Lanes         x2 = Lanes::load(_x2);
+    Lanes         y1 = Lanes::load(_y1);
+    Lanes         y2 = Lanes::load(_y2);
+    for (int i = 0; i < data.size(); ++i) {
+        const Lanes x0 = Lanes::load(data[i]);
+        const Lanes y0 = _a0 * y1 + _a1 * y2 + _b0 * x0 + _b1 * x1 + _b2 * x2;
+        y0.store(result[i]);
+        y2 = y1;
+        y1 = y0;
+        x2 = x1;
+        x1 = x0;
+    }
+    x1.store(_x1);
+    x2.store(_x2);
+    y1.store(_y1);
+    y2.store(_y2);
+    return result;
+}
+
+
+// --------------------------------------------------------------------------
+// BIQUAD CASCADE
+teleop::BiquadCascade::BiquadCascade(const QVector<Biquad>& sections,
+                                     QObject*               parent)
+    : QObject(parent) {
+    for (const Biquad& biquad : sections) {
+        Section section;
+        section.b0 = biquad.b0;
+        section.b1 = biquad.b1;
+        section.b2 = biquad.b2;
+        section.a1 = biquad.a1;
+        section.a2 = biquad.a2;
+        _sections.append(section);
+    }
+}
+
+
+teleop::Vec6 teleop::BiquadCascade::applyFilter(const Vec6& data) {
+    Lanes x = Lanes::load(data);
+    for (Section& section : _sections) {
+        // y = b0 x + s1, s1' = b1 x - a1 y + s2, s2' = b2 x - a2 y
+        const Lanes y = section.b0 * x + Lanes::load(section.s1);
+        (section.b1 * x - section.a1 * y + Lanes::load(section.s2))
+            .store(section.s1);
+        (section.b2 * x - section.a2 * y).store(section.s2);
+        x = y;
+    }
+    Vec6 result;
+    x.store(result);
+    return result;
+}
+
+
+QVector<teleop::Vec6>
+teleop::BiquadCascade::applyBatch(const QVector<Vec6>& data) {
+    QVector<Vec6> result(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        result[i] = applyFilter(data[i]);
+    }
+    return result;
+}
+
+
+// --------------------------------------------------------------------------
+// DEADBAND
+teleop::Deadband::Deadband(const Vec6& thresholds, QObject* parent)
+    : QObject(parent), _thresholds(thresholds) {
+}
+
+
+teleop::Vec6 teleop::Deadband::applyFilter(const Vec6& data) {
+    Vec6 result;
+    for (int i = 0; i < 6; ++i) {
+        if (data[i] > _thresholds[i]) {
+            result[i] = data[i] - _thresholds[i];
+        } else if (data[i] < -_thresholds[i]) {
+            result[i] = data[i] + _thresholds[i];
+        }
+    }
+    return result;
+}
+
+
+QVector<teleop::Vec6>
+teleop::Deadband::applyBatch(const QVector<Vec6>& data) {
+    QVector<Vec6> result(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        result[i] = applyFilter(data[i]);
+    }
+    return result;
+}
+
+
+// --------------------------------------------------------------------------
+// STATE ESTIMATORS
+namespace {
+
+float innovation(const teleop::Vec6& pose, float predicted, int i) {
+    const float result = pose[i] - predicted;
+    return i < 3 ? result : std::remainder(result, 360.0f);  // [deg]
+}
+
+}  // namespace
+
+
+teleop::KalmanEstimator::KalmanEstimator(const Vec6& noise, const Vec6& jerk,
+                                         QObject* parent)
+    : QObject(parent), _noise(noise), _jerk(jerk) {
+    update(Vec6(), 0);
+}
+
+
+teleop::Vec6 teleop::KalmanEstimator::update(const Vec6& pose, float step) {
+    if (step <= 0) {
+        // at rest, uncertain twist and acceleration
+        for (int i = 0; i < 6; ++i) {
+            Axis& axis = _axes[i];
+            axis.x[0]  = pose[i];
+            axis.x[1]  = 0;
+            axis.x[2]  = 0;
+            for (auto& row : axis.p) {
+                row[0] = row[1] = row[2] = 0;
+            }
+            axis.p[0][0] = double(_noise[i]) * _noise[i];
+            axis.p[1][1] = 1e6;
+            axis.p[2][2] = 1e10;
+        }
+        return getTwist();
+    }
+    const double h = step;
+    // F = [1 h h^2/2; 0 1 h; 0 0 1], Q of a white jerk
+    const double f[3][3] = {{1, h, h * h / 2}, {0, 1, h}, {0, 0, 1}};
+    const double q[3][3] = {{qPow(h, 5) / 20, qPow(h, 4) / 8, h * h * h / 6},
+                            {qPow(h, 4) / 8, h * h * h / 3, h * h / 2},
+                            {h * h * h / 6, h * h / 2, h}};
+    for (int i = 0; i < 6; ++i) {
+        Axis& axis = _axes[i];
+        // predict: x = F x, P = F P F' + Q
+        axis.x[0] += h * axis.x[1] + h * h / 2 * axis.x[2];
+        axis.x[1] += h * axis.x[2];
+        double fp[3][3];
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                fp[r][c] = f[r][0] * axis.p[0][c] + f[r][1] * axis.p[1][c] +
+                           f[r][2] * axis.p[2][c];
+            }
+        }
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                axis.p[r][c] = fp[r][0] * f[c][0] + fp[r][1] * f[c][1] +
+                               fp[r][2] * f[c][2] + _jerk[i] * q[r][c];
+            }
+        }
+        // correct with the measured pose, H = [1 0 0]
+        const double y = innovation(pose, axis.x[0], i);
+        const double s = axis.p[0][0] + double(_noise[i]) * _noise[i];
+        const double k[3] = {axis.p[0][0] / s, axis.p[1][0] / s,
+                             axis.p[2][0] / s};
+        const double p0[3] = {axis.p[0][0], axis.p[0][1], axis.p[0][2]};
+        for (int r = 0; r < 3; ++r) {
+            axis.x[r] += k[r] * y;
+            for (int c = 0; c < 3; ++c) {
+                axis.p[r][c] -= k[r] * p0[c];
+            }
+        }
+    }
+    return getTwist();
+}
+
+
+teleop::Vec6 teleop::KalmanEstimator::getPose() const {
+    Vec6 result;
+    for (int i = 0; i < 6; ++i) {
+        result[i] = _axes[i].x[0];
+    }
+    return result;
+}
+
+
+teleop::Vec6 teleop::KalmanEstimator::getTwist() const {
+    Vec6 result;
+    for (int i = 0; i < 6; ++i) {
+        result[i] = _axes[i].x[1];
+    }
+    return result;
+}
+
+
+teleop::Vec6 teleop::KalmanEstimator::getAcceleration() const {
+    Vec6 result;
+    for (int i = 0; i < 6; ++i) {
+        result[i] = _axes[i].x[2];
+    }
+    return result;
+}
+
+
+teleop::AlphaBetaGammaEstimator::AlphaBetaGammaEstimator(float    theta,
+                                                         QObject* parent)
+    : QObject(parent),
+      _alpha(1 - theta * theta * theta),
+      _beta(1.5f * (1 - theta * theta) * (1 - theta)),
+      _gamma(0.5f * (1 - theta) * (1 - theta) * (1 - theta)) {
+}
+
+
+teleop::Vec6 teleop::AlphaBetaGammaEstimator::update(const Vec6& pose,
+                                                     float       step) {
+    if (step <= 0) {
+        _pose         = pose;
+        _twist        = Vec6();
+        _acceleration = Vec6();
+        return _twist;
+    }
+    for (int i = 0; i < 6; ++i) {
+        const float pose_predicted =
+            _pose[i] + step * _twist[i] + step * step / 2 * _acceleration[i];
+        const float twist_predicted = _twist[i] + step * _acceleration[i];
+        const float y               = innovation(pose, pose_predicted, i);
+        _pose[i]                    = pose_predicted + _alpha * y;
+        _twist[i]                   = twist_predicted + _beta / step * y;
+        _acceleration[i] += 2 * _gamma / (step * step) * y;
+    }
+    return _twist;
+}
+
+
+teleop::Vec6 teleop::AlphaBetaGammaEstimator::getPose() const {
+    return _pose;
+}
+
+
+teleop::Vec6 teleop::AlphaBetaGammaEstimator::getTwist() const {
+    return _twist;
+}
+
+
+teleop::Vec6 teleop::AlphaBetaGammaEstimator::getAcceleration() const {
+    return _acceleration;
 }
@@ -1,8 +1,10 @@
 #ifndef FILTERS_H
 #define FILTERS_H
 
+#include "filter_design.h"
+#include "vec.h"
+
 #include <QObject>
-#include <QQueue>
 #include <QVector>
 
 
@@ -13,12 +15,15 @@ class SimpleMovingAverage : public QObject {
 
   public:
     SimpleMovingAverage(int window, QObject* parent = nullptr);
-    QVector<float> applyFilter(const QVector<float>& data);
+    Vec6          applyFilter(const Vec6& data);
+    QVector<Vec6> applyBatch(const QVector<Vec6>& data);  // e.g. a log channel
 
   private:
-    const int              _window;
-    QQueue<QVector<float>> _memory;
-    QVector<float>         _result = {0, 0, 0, 0, 0, 0};
+    const int     _window;
+    QVector<Vec6> _memory;     // ring of the last _window inputs
+    int           _next  = 0;  // oldest input once the ring is full
+    int           _count = 0;
+    Vec6          _result;
 };
 
 
@@ -27,14 +32,52 @@ class WeightedMovingAverage : public QObject {
 
   public:
     WeightedMovingAverage(int window, QObject* parent = nullptr);
-    QVector<float> applyFilter(const QVector<float>& data);
+    Vec6          applyFilter(const Vec6& data);
+    QVector<Vec6> applyBatch(const QVector<Vec6>& data);
+
+  private:
+    const int     _window;
+    QVector<Vec6> _memory;           // ring of the last _window inputs
+    int           _next        = 0;  // oldest input once the ring is full
+    int           _count       = 0;
+    float         _denominator = 0;  // weights sum
+    Vec6          _total;
+    Vec6          _numerator;
+};
+
+
+// Median of the last `window` values (the upper one when the count is
+// even): push() is O(log window), getMedian() O(1), no allocation after the
+// constructor. The values stay in a ring; a heap of ring indices is kept
+// around the median ("mediator", Hardle & Steiger): position 0 is the
+// median, the negative positions a max-heap of the lower half and the
+// positive ones a min-heap of the upper half. The oldest value is replaced
+// in place and sifted up or down.
+class SlidingMedian {
+  public:
+    explicit SlidingMedian(int window);
+
+    void  push(float value);
+    float getMedian() const;  // 0 before the first push()
+    int   getCount() const;
 
   private:
-    const int              _window;
-    QQueue<QVector<float>> _memory;
-    float                  _denominator = 0;  // weights sum
-    QVector<float>         _total       = {0, 0, 0, 0, 0, 0};
-    QVector<float>         _numerator   = {0, 0, 0, 0, 0, 0};
+    const int      _window;
+    QVector<float> _values;     // ring
+    QVector<int>   _positions;  // ring index -> heap position
+    QVector<int>   _heap;       // heap position + _window / 2 -> ring index
+    int            _next  = 0;  // ring index of the next push()
+    int            _count = 0;
+
+    int& _at(int position);
+    bool _less(int i, int j);
+    bool _exchangeIfLess(int i, int j);
+    int  _minCount() const;
+    int  _maxCount() const;
+    void _minSortDown(int i);
+    void _maxSortDown(int i);
+    bool _minSortUp(int i);
+    bool _maxSortUp(int i);
 };
 
 
@@ -43,17 +86,11 @@ class SimpleMovingMedian : public QObject {
 
   public:
     SimpleMovingMedian(int window, QObject* parent = nullptr);
-    QVector<float> applyFilter(const QVector<float>& data);
+    Vec6          applyFilter(const Vec6& data);
+    QVector<Vec6> applyBatch(const QVector<Vec6>& data);
 
   private:
-    const int              _window;
-    QQueue<QVector<float>> _memory;
-    QVector<float>         _bufferX;
-    QVector<float>         _bufferY;
-    QVector<float>         _bufferZ;
-    QVector<float>         _bufferR;
-    QVector<float>         _bufferP;
-    QVector<float>         _bufferW;
+    QVector<SlidingMedian> _medians;  // one per component
 };
 
 
@@ -65,21 +102,118 @@ class ButterworthLowPass : public QObject {
                        QObject* parent = nullptr);
     ButterworthLowPass(const QVector<float>& parameters,
                        QObject*              parent = nullptr);
-    QVector<float> applyFilter(const QVector<float>& data);
+    Vec6          applyFilter(const Vec6& data);
+    QVector<Vec6> applyBatch(const QVector<Vec6>& data);
+
+  private:
+    const float _b0;
+    const float _b1;
+    const float _b2;
+    const float _a0;
+    const float _a1;
+    Vec6        _x1;
+    Vec6        _x2;
+    Vec6        _y1;
+    Vec6        _y2;
+};
+
+
+// Cascade of second-order sections (e.g. designLowPass()), each in
+// transposed direct form II: two state vectors per section, which keeps the
+// rounding noise low with poles close to the unit circle.
+class BiquadCascade : public QObject {
+    Q_OBJECT
+
+  public:
+    BiquadCascade(const QVector<Biquad>& sections, QObject* parent = nullptr);
+    Vec6          applyFilter(const Vec6& data);
+    QVector<Vec6> applyBatch(const QVector<Vec6>& data);
 
   private:
-    const float    _b0;
-    const float    _b1;
-    const float    _b2;
-    const float    _a0;
-    const float    _a1;
-    QVector<float> _x1 = {0, 0, 0, 0, 0, 0};
-    QVector<float> _x2 = {0, 0, 0, 0, 0, 0};
-    QVector<float> _y1 = {0, 0, 0, 0, 0, 0};
-    QVector<float> _y2 = {0, 0, 0, 0, 0, 0};
+    struct Section {
+        float b0;
+        float b1;
+        float b2;
+        float a1;
+        float a2;
+        Vec6  s1;
+        Vec6  s2;
+    };
+
+    QVector<Section> _sections;
 };
 
 
+// Continuous deadband on each component: |x| <= threshold gives 0, beyond
+// the threshold is subtracted, so small jitter around zero is removed
+// without a step in the output.
+class Deadband : public QObject {
+    Q_OBJECT
+
+  public:
+    Deadband(const Vec6& thresholds, QObject* parent = nullptr);
+    Vec6          applyFilter(const Vec6& data);
+    QVector<Vec6> applyBatch(const QVector<Vec6>& data);
+
+  private:
+    const Vec6 _thresholds;
+};
+
+
+// Constant-acceleration Kalman filter of each pose component: the twist
+// comes from the timestamped poses instead of their difference, without the
+// group delay of a low pass on the differences. update() takes the pose and
+// the time since the previous one [s] and returns the twist; a step of 0
+// restarts from the pose at rest. noise: standard deviation of the measured
+// pose [mm, deg]; jerk: density of the jerk, the process noise
+// [mm^2/s^5, deg^2/s^5], higher follows faster and filters less. The angles
+// are Euler angles in [deg]: their innovation is wrapped to +-180.
+class KalmanEstimator : public QObject {
+    Q_OBJECT
+
+  public:
+    KalmanEstimator(const Vec6& noise, const Vec6& jerk,
+                    QObject* parent = nullptr);
+    Vec6 update(const Vec6& pose, float step);
+    Vec6 getPose() const;
+    Vec6 getTwist() const;
+    Vec6 getAcceleration() const;
+
+  private:
+    struct Axis {
+        double x[3];     // pose, twist, acceleration
+        double p[3][3];  // covariance
+    };
+
+    Axis       _axes[6];
+    const Vec6 _noise;
+    const Vec6 _jerk;
+};
+
+
+// Alpha-beta-gamma filter: the Kalman filter above with fixed gains, a few
+// multiply-adds per component. The gains are the critically damped ones of
+// the fading memory theta in (0, 1), the weight of the previous estimate:
+// closer to 1 filters more and lags more. Same update() as KalmanEstimator.
+class AlphaBetaGammaEstimator : public QObject {
+    Q_OBJECT
+
+  public:
+    AlphaBetaGammaEstimator(float theta, QObject* parent = nullptr);
+    Vec6 update(const Vec6& pose, float step);
+    Vec6 getPose() const;
+    Vec6 getTwist() const;
+    Vec6 getAcceleration() const;
+
+  private:
+    const float _alpha;
+    const float _beta;
+    const float _gamma;
+    Vec6        _pose;
+    Vec6        _twist;
+    Vec6        _acceleration;
+};
+
 }  // namespace teleop
 
 
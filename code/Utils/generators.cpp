@@ -1,5 +1,6 @@
 #include "generators.h"
 #include "kinematic.h"
+#include "log_warning.h"
 #include "logs.h"
 #include "settings.h"
 
@@ -15,7 +16,7 @@ QMatrix4x4 _adj;
 
 // ==========================================================================
 teleop::MotionGenerator::MotionGenerator(QObject* parent) : QObject(parent) {
-    qDebug(logGenerators())
+    TELEOP_DEBUG(logGenerators)
         << QThread::currentThreadId() << " | MotionGenerator created";
     // get infos
     auto& settings    = SettingsManager::getInstance();
@@ -23,10 +24,10 @@ teleop::MotionGenerator::MotionGenerator(QObject* parent) : QObject(parent) {
     _newPoseThreshold = settings.getFloat("task/new_pose_threshold");
     _relativeMode     = settings.getRelativeMode("task/relative_mode");
     // all
-    _wsl_T_ori = poseXYZ_to_matrix(settings.getQVector("task/wsl_T_ori"));
-    _ori_T_wma = poseXYZ_to_matrix(settings.getQVector("task/ori_T_wma"));
+    _wsl_T_ori = poseXYZ_to_matrix(settings.getVec6("task/wsl_T_ori"));
+    _ori_T_wma = poseXYZ_to_matrix(settings.getVec6("task/ori_T_wma"));
     _wsl_T_wma = _wsl_T_ori * _ori_T_wma;
-    _hip_T_pen = poseXYZ_to_matrix(settings.getQVector("task/hip_T_pen"));
+    _hip_T_pen = poseXYZ_to_matrix(settings.getVec6("task/hip_T_pen"));
     _pen_T_tcp = _ori_T_wma.inverted();
     _hip_T_tcp = _hip_T_pen * _pen_T_tcp;
     // relative
@@ -47,14 +48,17 @@ teleop::MotionGenerator::MotionGenerator(QObject* parent) : QObject(parent) {
 }
 
 
-void teleop::MotionGenerator::update(const QVector<float>& pose) {
+void teleop::MotionGenerator::update(const Vec6& pose) {
     if (_firstTime) {
         _timer.start();
+        _timeStep          = 0;
         _firstTime         = false;
         _currPose          = pose;
         _lastPose          = pose;
         _lastPosePerformed = _currPose;
     } else {
+        _timeStep = _timer.nsecsElapsed() * 1e-9;
+        _timer.start();
         _lastPose = _currPose;
         _currPose = pose;
     }
@@ -72,6 +76,7 @@ void teleop::MotionGenerator::update(const QMatrix4x4& wma_T_hip,
     //                     _ori_T_wma.inverted();
     if (restart || _firstTime) {
         _timer.start();
+        _timeStep  = 0;
         _firstTime = false;
         // twist
         _currPose = matrix_to_poseXYZ(wsl_T_tcp);
@@ -103,6 +108,8 @@ void teleop::MotionGenerator::update(const QMatrix4x4& wma_T_hip,
         _adj(1, 3) = 0;
         _adj(2, 3) = 0;
     } else {
+        _timeStep = _timer.nsecsElapsed() * 1e-9;
+        _timer.start();
         _lastPose = _currPose;
         _currPose = matrix_to_poseXYZ(wsl_T_tcp);
     }
@@ -121,7 +128,7 @@ void teleop::MotionGenerator::reIndexing() {
 }
 
 
-QVector<float> teleop::MotionGenerator::getRelativePose() {
+teleop::Vec6 teleop::MotionGenerator::getRelativePose() {
     switch (_relativeMode) {
         case RelativeMode::fix: {
             _wsl_T_tcp = _wsl_T_cur * _ref_T_wma * _wma_T_hip * _hip_T_tcp;
@@ -141,25 +148,21 @@ QVector<float> teleop::MotionGenerator::getRelativePose() {
 }
 
 
-QVector<float> teleop::MotionGenerator::getAbsolutePose() {
+teleop::Vec6 teleop::MotionGenerator::getAbsolutePose() {
     return _currPose;
 }
 
 
-QVector<float> teleop::MotionGenerator::getTwist() {
-    float time = _timer.nsecsElapsed() * 1e-9;  // [sec]
-    _timer.start();
-    if (time == 0) {
-        qWarning() << "Try to generate twist with time elapsed == 0...";
+teleop::Vec6 teleop::MotionGenerator::getTwist() {
+    if (_timeStep == 0) {
+        return Vec6();  // (re)start: no previous pose
     }
-    // clang-format off
-    return{(_currPose[0] - _lastPose[0]) / time,
-           (_currPose[1] - _lastPose[1]) / time,
-           (_currPose[2] - _lastPose[2]) / time,
-           (_currPose[3] - _lastPose[3]) / time,
-           (_currPose[4] - _lastPose[4]) / time,
-           (_currPose[5] - _lastPose[5]) / time};
-    // clang-format on
+    return (_currPose - _lastPose) / _timeStep;
+}
+
+
+float teleop::MotionGenerator::getTimeStep() {
+    return _timeStep;
 }
 
 
@@ -173,12 +176,7 @@ bool teleop::MotionGenerator::isEnoughDistant() {
 
 
 float teleop::MotionGenerator::_getPoseDistanceFromLast() {
-    return qSqrt(qPow((_currPose[0] - _lastPosePerformed[0]), 2) +
-                 qPow((_currPose[1] - _lastPosePerformed[1]), 2) +
-                 qPow((_currPose[2] - _lastPosePerformed[2]), 2) +
-                 qPow((_currPose[3] - _lastPosePerformed[3]), 2) +
-                 qPow((_currPose[4] - _lastPosePerformed[4]), 2) +
-                 qPow((_currPose[5] - _lastPosePerformed[5]), 2));
+    return (_currPose - _lastPosePerformed).norm();
 }
 
 
@@ -192,32 +190,28 @@ teleop::ForceGenerator::ForceGenerator(QObject* parent) : QObject(parent) {
     auto& settings = SettingsManager::getInstance();
     _stiffness     = settings.getFloat("task/feedback_stiffness");
     _forceLimit    = settings.getFloat("task/feedback_max_force");
-    auto wsl_T_ori = settings.getQVector("task/wsl_T_ori");
-    _origin        = {wsl_T_ori[0], wsl_T_ori[1], wsl_T_ori[2]};
+    _origin        = settings.getVec6("task/wsl_T_ori").head<3>();
     _wma_T_ori =
-        poseXYZ_to_matrix(settings.getQVector("task/ori_T_wma")).inverted();
+        poseXYZ_to_matrix(settings.getVec6("task/ori_T_wma")).inverted();
 }
 
 
-QVector<float>
-teleop::ForceGenerator::_reMapping(const QVector<float>& wrench) {
+teleop::Vec6 teleop::ForceGenerator::_reMapping(const Vec6& wrench) {
     auto result =
         matrix_to_poseXYZ(_adj * _wma_T_ori * poseXYZ_to_matrix(wrench));
 
     for (int i = 0; i < 3; ++i) {
         if (result[i] < -_forceLimit) {
-            qWarning(logGenerators()).nospace()
-                << "time=" << LogClock::getInstance().getMilliseconds()
-                << " wrench[" << i << "]=" << result[i]
-                << " is minor of the force limit:" << -_forceLimit;
+            TELEOP_WARN_AGGREGATED(logGenerators,
+                                   "wrench minor of the force limit",
+                                   result[i]);
             //            result[i] = 0;
             result[i] = -_forceLimit;
         }
         if (result[i] > _forceLimit) {
-            qWarning(logGenerators()).nospace()
-                << "time=" << LogClock::getInstance().getMilliseconds()
-                << " wrench[" << i << "]=" << result[i]
-                << " is major of the force limit:" << _forceLimit;
+            TELEOP_WARN_AGGREGATED(logGenerators,
+                                   "wrench major of the force limit",
+                                   result[i]);
             //            result[i] = 0;
             result[i] = _forceLimit;
         }
@@ -229,15 +223,14 @@ teleop::ForceGenerator::_reMapping(const QVector<float>& wrench) {
 }
 
 
-QVector<float>
-teleop::ForceGenerator::_getVecDifference(const QVector<float>& a,
-                                          const QVector<float>& b) {
-    return {(a[0] - b[0]), (a[1] - b[1]), (a[2] - b[2])};
+teleop::Vec3 teleop::ForceGenerator::_getVecDifference(const Vec3& a,
+                                                       const Vec3& b) {
+    return a - b;
 }
 
 
-QVector<float> teleop::ForceGenerator::_getVecScaling(const QVector<float>& a,
-                                                      float factor) {
+teleop::Vec3 teleop::ForceGenerator::_getVecScaling(const Vec3& a,
+                                                    float       factor) {
     auto v = a;
     for (int i = 0; i < v.size(); ++i) {
         v[i] *= factor;
@@ -249,14 +242,13 @@ QVector<float> teleop::ForceGenerator::_getVecScaling(const QVector<float>& a,
 }
 
 
-float teleop::ForceGenerator::_getVecMagnitude(const QVector<float>& a) {
-    return qSqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+float teleop::ForceGenerator::_getVecMagnitude(const Vec3& a) {
+    return a.norm();
 }
 
 
-QVector<float>
-teleop::ForceGenerator::_getVecDirection(const QVector<float>& a,
-                                         const QVector<float>& b) {
+teleop::Vec3 teleop::ForceGenerator::_getVecDirection(const Vec3& a,
+                                                      const Vec3& b) {
     auto  v = _getVecDifference(a, b);
     float m = _getVecMagnitude(v);
     return _getVecScaling(v, 1 / m);
@@ -266,19 +258,16 @@ teleop::ForceGenerator::_getVecDirection(const QVector<float>& a,
 // ==========================================================================
 teleop::SphereForceGenerator::SphereForceGenerator(QObject* parent)
     : ForceGenerator(parent) {
-    qDebug(logGenerators())
+    TELEOP_DEBUG(logGenerators)
         << QThread::currentThreadId() << " | SphereForceGenerator created";
-    _origin[0] += _offset[0];
-    _origin[1] += _offset[1];
-    _origin[2] += _offset[2];
+    _origin += _offset;
 }
 
 
-QVector<float>
-teleop::SphereForceGenerator::getForceFrom(const QVector<float>& pose) {
-    QVector<float> difference  = _getVecDifference(pose, _origin);
-    double         distance    = _getVecMagnitude(difference);
-    double         penetration = _radius - distance;
+teleop::Vec6 teleop::SphereForceGenerator::getForceFrom(const Vec6& pose) {
+    Vec3   difference  = _getVecDifference(pose.head<3>(), _origin);
+    double distance    = _getVecMagnitude(difference);
+    double penetration = _radius - distance;
 
     if (penetration <= 0) {
         return {0, 0, 0, 0, 0, 0};
@@ -295,17 +284,14 @@ teleop::SphereForceGenerator::getForceFrom(const QVector<float>& pose) {
 // ==========================================================================
 teleop::AnchorForceGenerator::AnchorForceGenerator(QObject* parent)
     : ForceGenerator(parent) {
-    qDebug(logGenerators())
+    TELEOP_DEBUG(logGenerators)
         << QThread::currentThreadId() << " | AnchorForceGenerator created";
-    _origin[0] += _offset[0];
-    _origin[1] += _offset[1];
-    _origin[2] += _offset[2];
+    _origin += _offset;
 }
 
 
-QVector<float>
-teleop::AnchorForceGenerator::getForceFrom(const QVector<float>& pose) {
-    QVector<float> difference = _getVecDifference(_origin, pose);
+teleop::Vec6 teleop::AnchorForceGenerator::getForceFrom(const Vec6& pose) {
+    Vec3 difference = _getVecDifference(_origin, pose.head<3>());
 
     float x = _stiffness * difference[0];
     float y = _stiffness * difference[1];
@@ -318,13 +304,12 @@ teleop::AnchorForceGenerator::getForceFrom(const QVector<float>& pose) {
 // ==========================================================================
 teleop::LinearForceGenerator::LinearForceGenerator(QObject* parent)
     : ForceGenerator(parent) {
-    qDebug(logGenerators())
+    TELEOP_DEBUG(logGenerators)
         << QThread::currentThreadId() << " | LinearForceGenerator created";
 }
 
 
-QVector<float>
-teleop::LinearForceGenerator::getForceFrom(const QVector<float>& pose) {
+teleop::Vec6 teleop::LinearForceGenerator::getForceFrom(const Vec6& pose) {
     float x = 0;
     float y = _stiffness * (_origin[1] - pose[1]);
     float z = _stiffness * (_origin[2] - pose[2]);
@@ -341,7 +326,7 @@ teleop::LinearForceGenerator::getForceFrom(const QVector<float>& pose) {
 // ==========================================================================
 teleop::TriangleForceGenerator::TriangleForceGenerator(QObject* parent)
     : ForceGenerator(parent) {
-    qDebug(logGenerators())
+    TELEOP_DEBUG(logGenerators)
         << QThread::currentThreadId() << " | TriangleForceGenerator created";
 
     auto& settings = SettingsManager::getInstance();
@@ -352,8 +337,7 @@ teleop::TriangleForceGenerator::TriangleForceGenerator(QObject* parent)
 }
 
 
-QVector<float>
-teleop::TriangleForceGenerator::getForceFrom(const QVector<float>& pose) {
+teleop::Vec6 teleop::TriangleForceGenerator::getForceFrom(const Vec6& pose) {
     float progress = (pose[0] - _origin[0]) - _offset * _direction;
     float goal     = _process(progress * _direction);
 
@@ -381,18 +365,17 @@ float teleop::TriangleForceGenerator::_process(float progress) {
 // ==========================================================================
 teleop::OpponentForceGenerator::OpponentForceGenerator(QObject* parent)
     : ForceGenerator(parent) {
-    qDebug(logGenerators())
+    TELEOP_DEBUG(logGenerators)
         << QThread::currentThreadId() << " | OpponentForceGenerator created";
 }
 
 
-QVector<float>
-teleop::OpponentForceGenerator::getForceFrom(const QVector<float>& pose) {
+teleop::Vec6 teleop::OpponentForceGenerator::getForceFrom(const Vec6& pose) {
     if (_firstTime) {
         _firstTime = false;
         return {0, 0, 0, 0, 0, 0};
     }
-    auto  diff      = _getVecDifference(pose, _lastPose);
+    auto  diff = _getVecDifference(pose.head<3>(), _lastPose.head<3>());
     float magnitude = _getVecMagnitude(diff);
     auto  versor    = _getVecScaling(diff, 1 / magnitude);
     _lastPose       = pose;
@@ -420,6 +403,6 @@ teleop::OpponentForceGenerator::getForceFrom(const QVector<float>& pose) {
     float y = _current;
     float z = 0;
 
-    qDebug(logGenerators()) << x << y << z;
+    TELEOP_DEBUG(logGenerators) << x << y << z;
     return _reMapping({x, y, z, 0, 0, 0});
 }
@@ -1,7 +1,9 @@
 #ifndef GENERATORS_H
 #define GENERATORS_H
 
+#include "log_level.h"
 #include "settings.h"
+#include "vec.h"
 
 #include <QElapsedTimer>
 #include <QLoggingCategory>
@@ -10,6 +12,7 @@
 #include <QVector>
 
 Q_DECLARE_LOGGING_CATEGORY(logGenerators)
+TELEOP_LOG_MIN_LEVEL(logGenerators, TELEOP_LOG_LEVEL)
 
 
 namespace teleop {
@@ -23,18 +26,21 @@ class MotionGenerator : public QObject {
     MotionGenerator(const MotionGenerator&) = delete;
     MotionGenerator(MotionGenerator&&)      = delete;
 
-    void           update(const QMatrix4x4& wma_T_hip, bool restart);  // touch
-    void           reIndexing();
-    QVector<float> getRelativePose();
-    QVector<float> getAbsolutePose();
-    QVector<float> getTwist();
-    bool           isEnoughDistant();
+    void  update(const Vec6& pose);                           // pose source
+    void  update(const QMatrix4x4& wma_T_hip, bool restart);  // touch
+    void  reIndexing();
+    Vec6  getRelativePose();
+    Vec6  getAbsolutePose();
+    Vec6  getTwist();     // difference of the last two poses
+    float getTimeStep();  // [s] between them, 0 after a (re)start
+    bool  isEnoughDistant();
 
   private:
     bool          _firstTime     = true;
     float         _scalingFactor = 1.0;
     RelativeMode  _relativeMode  = RelativeMode::fix;
     QElapsedTimer _timer;
+    float         _timeStep      = 0;  // [s]
     // all
     QMatrix4x4 _wsl_T_ori;
     QMatrix4x4 _ori_T_wma;
@@ -49,11 +55,11 @@ class MotionGenerator : public QObject {
     QMatrix4x4 _ref_T_wma;
     QMatrix4x4 _hip_T_adj;
     // for Twist mode
-    QVector<float> _currPose;
-    QVector<float> _lastPose;
+    Vec6 _currPose;
+    Vec6 _lastPose;
     // for Pose optimization
-    float          _newPoseThreshold;
-    QVector<float> _lastPosePerformed;
+    float _newPoseThreshold;
+    Vec6  _lastPosePerformed;
     // for reindexing
     QMatrix4x4 _wsl_T_tcp;
 
@@ -72,21 +78,19 @@ class ForceGenerator : public QObject {
     ForceGenerator(const ForceGenerator&) = delete;
     ForceGenerator(ForceGenerator&&)      = delete;
 
-    virtual QVector<float> getForceFrom(const QVector<float>& pose) = 0;
+    virtual Vec6 getForceFrom(const Vec6& pose) = 0;
 
   protected:
-    float          _stiffness  = 0.25;
-    float          _forceLimit = 1.0f;
-    QVector<float> _origin     = {0, 0, 0};
-    QMatrix4x4     _wma_T_ori;
-
-    QVector<float> _reMapping(const QVector<float>& wrench);
-    QVector<float> _getVecDifference(const QVector<float>& a,
-                                     const QVector<float>& b);
-    QVector<float> _getVecScaling(const QVector<float>& a, float factor);
-    float          _getVecMagnitude(const QVector<float>& a);
-    QVector<float> _getVecDirection(const QVector<float>& a,
-                                    const QVector<float>& b);
+    float      _stiffness  = 0.25;
+    float      _forceLimit = 1.0f;
+    Vec3       _origin;
+    QMatrix4x4 _wma_T_ori;
+
+    Vec6  _reMapping(const Vec6& wrench);
+    Vec3  _getVecDifference(const Vec3& a, const Vec3& b);
+    Vec3  _getVecScaling(const Vec3& a, float factor);
+    float _getVecMagnitude(const Vec3& a);
+    Vec3  _getVecDirection(const Vec3& a, const Vec3& b);
 };
 
 // ==========================================================================
@@ -98,11 +102,11 @@ class SphereForceGenerator : public ForceGenerator {
     SphereForceGenerator(const SphereForceGenerator&) = delete;
     SphereForceGenerator(SphereForceGenerator&&)      = delete;
 
-    QVector<float> getForceFrom(const QVector<float>& pose) override;
+    Vec6 getForceFrom(const Vec6& pose) override;
 
   private:
-    QVector<float> _offset = {0, 0, -100};
-    float          _radius = 40.0;
+    Vec3  _offset = {0, 0, -100};
+    float _radius = 40.0;
 };
 
 // ==========================================================================
@@ -114,10 +118,10 @@ class AnchorForceGenerator : public ForceGenerator {
     AnchorForceGenerator(const AnchorForceGenerator&) = delete;
     AnchorForceGenerator(AnchorForceGenerator&&)      = delete;
 
-    QVector<float> getForceFrom(const QVector<float>& pose) override;
+    Vec6 getForceFrom(const Vec6& pose) override;
 
   private:
-    QVector<float> _offset = {0, 0, 0};
+    Vec3 _offset = {0, 0, 0};
 };
 
 // ==========================================================================
@@ -129,7 +133,7 @@ class LinearForceGenerator : public ForceGenerator {
     LinearForceGenerator(const LinearForceGenerator&) = delete;
     LinearForceGenerator(LinearForceGenerator&&)      = delete;
 
-    QVector<float> getForceFrom(const QVector<float>& pose) override;
+    Vec6 getForceFrom(const Vec6& pose) override;
 };
 
 // ==========================================================================
@@ -141,7 +145,7 @@ class TriangleForceGenerator : public ForceGenerator {
     TriangleForceGenerator(const TriangleForceGenerator&) = delete;
     TriangleForceGenerator(TriangleForceGenerator&&)      = delete;
 
-    QVector<float> getForceFrom(const QVector<float>& pose) override;
+    Vec6 getForceFrom(const Vec6& pose) override;
 
   private:
     float _offset    = 0;
@@ -161,11 +165,11 @@ class OpponentForceGenerator : public ForceGenerator {
     OpponentForceGenerator(const OpponentForceGenerator&) = delete;
     OpponentForceGenerator(OpponentForceGenerator&&)      = delete;
 
-    QVector<float> getForceFrom(const QVector<float>& pose) override;
+    Vec6 getForceFrom(const Vec6& pose) override;
 
   private:
-    bool           _firstTime = true;
-    QVector<float> _lastPose  = {0, 0, 0, 0, 0, 0};
+    bool _firstTime = true;
+    Vec6 _lastPose;
 
     float _force              = 0.6;
     float _current            = 0;
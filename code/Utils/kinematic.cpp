@@ -9,7 +9,7 @@ Q_LOGGING_CATEGORY(logKinematic, "Kinematic")
 
 // ==========================================================================
 // MOBILE XYZ rotation convention
-QVector<float> teleop::matrix_to_poseXYZ(const QMatrix4x4& matrix) {
+teleop::Vec6 teleop::matrix_to_poseXYZ(const QMatrix4x4& matrix) {
     // Get position
     const float x = matrix(0, 3);
     const float y = matrix(1, 3);
@@ -40,7 +40,7 @@ QVector<float> teleop::matrix_to_poseXYZ(const QMatrix4x4& matrix) {
 }
 
 
-QMatrix4x4 teleop::poseXYZ_to_matrix(const QVector<float>& pose) {
+QMatrix4x4 teleop::poseXYZ_to_matrix(const Vec6& pose) {
     const float a  = pose[3] * M_PI / 180.0;  // [rad]
     const float b  = pose[4] * M_PI / 180.0;  // [rad]
     const float c  = pose[5] * M_PI / 180.0;  // [rad]
@@ -62,7 +62,7 @@ QMatrix4x4 teleop::poseXYZ_to_matrix(const QVector<float>& pose) {
 
 // ==========================================================================
 // MOBILE ZYX rotation convention
-QVector<float> teleop::matrix_to_poseZYX(const QMatrix4x4& matrix) {
+teleop::Vec6 teleop::matrix_to_poseZYX(const QMatrix4x4& matrix) {
     // Get position
     const float x = matrix(0, 3);
     const float y = matrix(1, 3);
@@ -93,7 +93,7 @@ QVector<float> teleop::matrix_to_poseZYX(const QMatrix4x4& matrix) {
 }
 
 
-QMatrix4x4 teleop::poseZYX_to_matrix(const QVector<float>& pose) {
+QMatrix4x4 teleop::poseZYX_to_matrix(const Vec6& pose) {
     const float a  = pose[5] * M_PI / 180.0;  // [rad]
     const float b  = pose[4] * M_PI / 180.0;  // [rad]
     const float c  = pose[3] * M_PI / 180.0;  // [rad]
@@ -113,14 +113,13 @@ QMatrix4x4 teleop::poseZYX_to_matrix(const QVector<float>& pose) {
 }
 
 
-QVector<float> teleop::matrix_to_poseXYZ_fixed(const QMatrix4x4& matrix) {
+teleop::Vec6 teleop::matrix_to_poseXYZ_fixed(const QMatrix4x4& matrix) {
     auto output = matrix_to_poseZYX(matrix);
     return {output[0], output[1], output[2], output[5], output[4], output[3]};
 }
 
 
-QMatrix4x4 teleop::poseXYZ_to_matrix_fixed(const QVector<float>& pose) {
-    QVector<float> input = {pose[0], pose[1], pose[2],
-                            pose[5], pose[4], pose[3]};
+QMatrix4x4 teleop::poseXYZ_to_matrix_fixed(const Vec6& pose) {
+    const Vec6 input = {pose[0], pose[1], pose[2], pose[5], pose[4], pose[3]};
     return poseZYX_to_matrix(input);
 }
@@ -1,6 +1,8 @@
 #ifndef KINEMATICS_H
 #define KINEMATICS_H
 
+#include "vec.h"
+
 #include <QElapsedTimer>
 #include <QLoggingCategory>
 #include <QMatrix4x4>
@@ -15,16 +17,16 @@ namespace teleop {
 // ==========================================================================
 // Pose: XYZ [mm], Roll-Pitch-Yaw [degrees]
 // Rotation convention: mobile XYZ (== fixed ZYX)
-QVector<float> matrix_to_poseXYZ(const QMatrix4x4& matrix);
-QMatrix4x4     poseXYZ_to_matrix(const QVector<float>& pose);
+Vec6       matrix_to_poseXYZ(const QMatrix4x4& matrix);
+QMatrix4x4 poseXYZ_to_matrix(const Vec6& pose);
 
 // ==========================================================================
 // Pose: XYZ [mm], Yaw-Pitch-Roll [degrees]
 // Rotation convention: mobile ZYX (== fixed XYZ)
-QVector<float> matrix_to_poseZYX(const QMatrix4x4& matrix);
-QMatrix4x4     poseZYX_to_matrix(const QVector<float>& pose);
-QVector<float> matrix_to_poseXYZ_fixed(const QMatrix4x4& matrix);
-QMatrix4x4     poseXYZ_to_matrix_fixed(const QVector<float>& pose);
+Vec6       matrix_to_poseZYX(const QMatrix4x4& matrix);
+QMatrix4x4 poseZYX_to_matrix(const Vec6& pose);
+Vec6       matrix_to_poseXYZ_fixed(const QMatrix4x4& matrix);
+QMatrix4x4 poseXYZ_to_matrix_fixed(const Vec6& pose);
 
 }  // namespace teleop
 
@@ -0,0 +1,221 @@
+#ifndef LANES_H
+#define LANES_H
+
+#include "vec.h"
+
+#if !defined(TELEOP_NO_SIMD) && defined(__AVX__)
+#define TELEOP_LANES_AVX
+#include <immintrin.h>
+#elif !defined(TELEOP_NO_SIMD) && defined(__SSE__)
+#define TELEOP_LANES_SSE
+#include <xmmintrin.h>
+#endif
+
+
+namespace teleop {
+
+// ==========================================================================
+// Eight float lanes updated together: a Vec6 padded with two zero lanes, so
+// a filter step on the six axes takes a few vector instructions. One AVX
+// register when the build enables it (-mavx), two SSE registers otherwise
+// (always there on x86-64), a plain loop elsewhere or with
+// DEFINES += TELEOP_NO_SIMD. Every operator is one IEEE operation per lane:
+// the three versions give bit-identical results as long as the compiler
+// does not fuse a multiply and an add (-ffp-contract=off in Utils.pro).
+// A float converts to a Lanes with the value in every lane.
+// Temporaries only: an AVX register is 32-byte aligned, which operator new
+// does not guarantee before C++17, so the filters keep their state in Vec6.
+class Lanes {
+  public:
+    Lanes() = default;  // uninitialized
+    Lanes(float value);
+
+    static Lanes load(const Vec6& vec);
+    void         store(Vec6& vec) const;
+
+    friend Lanes operator+(const Lanes& a, const Lanes& b);
+    friend Lanes operator-(const Lanes& a, const Lanes& b);
+    friend Lanes operator*(const Lanes& a, const Lanes& b);
+    friend Lanes operator/(const Lanes& a, const Lanes& b);
+
+  private:
+#if defined(TELEOP_LANES_AVX)
+    __m256 _v;
+#elif defined(TELEOP_LANES_SSE)
+    __m128 _lo;  // lanes 0-3
+    __m128 _hi;  // lanes 4-7
+#else
+    float _v[8];
+#endif
+};
+
+
+// ==========================================================================
+#if defined(TELEOP_LANES_AVX)
+
+inline Lanes::Lanes(float value) : _v(_mm256_set1_ps(value)) {
+}
+
+
+inline Lanes Lanes::load(const Vec6& vec) {
+    // the padding of a Vec6 is never read
+    Lanes result;
+    result._v = _mm256_maskload_ps(
+        vec.values, _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0));
+    return result;
+}
+
+
+inline void Lanes::store(Vec6& vec) const {
+    _mm256_maskstore_ps(vec.values,
+                        _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0), _v);
+}
+
+
+inline Lanes operator+(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    result._v = _mm256_add_ps(a._v, b._v);
+    return result;
+}
+
+
+inline Lanes operator-(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    result._v = _mm256_sub_ps(a._v, b._v);
+    return result;
+}
+
+
+inline Lanes operator*(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    result._v = _mm256_mul_ps(a._v, b._v);
+    return result;
+}
+
+
+inline Lanes operator/(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    result._v = _mm256_div_ps(a._v, b._v);
+    return result;
+}
+
+#elif defined(TELEOP_LANES_SSE)
+
+inline Lanes::Lanes(float value)
+    : _lo(_mm_set1_ps(value)), _hi(_mm_set1_ps(value)) {
+}
+
+
+inline Lanes Lanes::load(const Vec6& vec) {
+    // the padding of a Vec6 is never read
+    Lanes result;
+    result._lo = _mm_loadu_ps(vec.values);
+    result._hi = _mm_loadl_pi(_mm_setzero_ps(),
+                              reinterpret_cast<const __m64*>(vec.values + 4));
+    return result;
+}
+
+
+inline void Lanes::store(Vec6& vec) const {
+    _mm_storeu_ps(vec.values, _lo);
+    _mm_storel_pi(reinterpret_cast<__m64*>(vec.values + 4), _hi);
+}
+
+
+inline Lanes operator+(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    result._lo = _mm_add_ps(a._lo, b._lo);
+    result._hi = _mm_add_ps(a._hi, b._hi);
+    return result;
+}
+
+
+inline Lanes operator-(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    result._lo = _mm_sub_ps(a._lo, b._lo);
+    result._hi = _mm_sub_ps(a._hi, b._hi);
+    return result;
+}
+
+
+inline Lanes operator*(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    result._lo = _mm_mul_ps(a._lo, b._lo);
+    result._hi = _mm_mul_ps(a._hi, b._hi);
+    return result;
+}
+
+
+inline Lanes operator/(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    result._lo = _mm_div_ps(a._lo, b._lo);
+    result._hi = _mm_div_ps(a._hi, b._hi);
+    return result;
+}
+
+#else
+
+inline Lanes::Lanes(float value) {
+    for (float& lane : _v) {
+        lane = value;
+    }
+}
+
+
+inline Lanes Lanes::load(const Vec6& vec) {
+    Lanes result;
+    for (int i = 0; i < 8; ++i) {
+        result._v[i] = i < 6 ? vec.values[i] : 0;
+    }
+    return result;
+}
+
+
+inline void Lanes::store(Vec6& vec) const {
+    for (int i = 0; i < 6; ++i) {
+        vec.values[i] = _v[i];
+    }
+}
+
+
+inline Lanes operator+(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    for (int i = 0; i < 8; ++i) {
+        result._v[i] = a._v[i] + b._v[i];
+    }
+    return result;
+}
+
+
+inline Lanes operator-(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    for (int i = 0; i < 8; ++i) {
+        result._v[i] = a._v[i] - b._v[i];
+    }
+    return result;
+}
+
+
+inline Lanes operator*(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    for (int i = 0; i < 8; ++i) {
+        result._v[i] = a._v[i] * b._v[i];
+    }
+    return result;
+}
+
+
+inline Lanes operator/(const Lanes& a, const Lanes& b) {
+    Lanes result;
+    for (int i = 0; i < 8; ++i) {
+        result._v[i] = a._v[i] / b._v[i];
+    }
+    return result;
+}
+
+#endif
+
+}  // namespace teleop
+
+
+#endif  // LANES_H
@@ -0,0 +1,159 @@
+#include "latency.h"
+#include "logs.h"
+#include "settings.h"
+
+#include <QDebug>
+
+
+// ==========================================================================
+teleop::LatencyHistogram::LatencyHistogram(const QString& name)
+    : _name(name), _count(0), _sum(0), _max(0) {
+    for (auto& bucket : _buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+
+void teleop::LatencyHistogram::record(quint64 ns) {
+    _buckets[_bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(ns, std::memory_order_relaxed);
+    quint64 max = _max.load(std::memory_order_relaxed);
+    while (ns > max &&
+           !_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+
+const QString& teleop::LatencyHistogram::getName() const {
+    return _name;
+}
+
+
+quint64 teleop::LatencyHistogram::getCount() const {
+    return _count.load(std::memory_order_relaxed);
+}
+
+
+quint64 teleop::LatencyHistogram::getSum() const {
+    return _sum.load(std::memory_order_relaxed);
+}
+
+
+quint64 teleop::LatencyHistogram::getMax() const {
+    return _max.load(std::memory_order_relaxed);
+}
+
+
+quint64 teleop::LatencyHistogram::getPercentile(double percentile) const {
+    const quint64 count = getCount();
+    if (count == 0) {
+        return 0;
+    }
+    const quint64 rank = qMax<quint64>(1, quint64(percentile / 100 * count));
+    quint64       seen = 0;
+    for (int i = 0; i < _bucketCount; ++i) {
+        seen += _buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return qMin(_upperBoundOf(i), getMax());
+        }
+    }
+    return getMax();
+}
+
+
+QString teleop::LatencyHistogram::getSummary() const {
+    return QString("%1: n=%2 p50=%3us p99=%4us p99.9=%5us max=%6us")
+        .arg(_name)
+        .arg(getCount())
+        .arg(getPercentile(50) * 1e-3, 0, 'f', 1)
+        .arg(getPercentile(99) * 1e-3, 0, 'f', 1)
+        .arg(getPercentile(99.9) * 1e-3, 0, 'f', 1)
+        .arg(getMax() * 1e-3, 0, 'f', 1);
+}
+
+
+int teleop::LatencyHistogram::_bucketOf(quint64 ns) {
+    if (ns < quint64(_subCount)) {
+        return int(ns);
+    }
+    const int msb   = 63 - __builtin_clzll(ns);
+    const int shift = msb - _subBits;
+    return (shift + 1) * _subCount + int((ns >> shift) - _subCount);
+}
+
+
+quint64 teleop::LatencyHistogram::_upperBoundOf(int bucket) {
+    if (bucket < _subCount) {
+        return quint64(bucket);
+    }
+    const int     shift = bucket / _subCount - 1;
+    const quint64 sub   = quint64(bucket % _subCount + _subCount);
+    return ((sub + 1) << shift) - 1;
+}
+
+
+// ==========================================================================
+teleop::LatencyMonitor& teleop::LatencyMonitor::getInstance() {
+    static LatencyMonitor instance;
+    return instance;
+}
+
+
+teleop::LatencyMonitor::LatencyMonitor() {
+    _histograms[int(LatencyStage::touchToSupervisor)] =
+        new LatencyHistogram("touch->supervisor");
+    _histograms[int(LatencyStage::touchToMecaNode)] =
+        new LatencyHistogram("touch->meca_node");
+    _histograms[int(LatencyStage::requestToCommand)] =
+        new LatencyHistogram("meca_node->command");
+    _histograms[int(LatencyStage::touchToCommand)] =
+        new LatencyHistogram("touch->command");
+    _histograms[int(LatencyStage::touchToFeedback)] =
+        new LatencyHistogram("touch->feedback");
+    _period = SettingsManager::getInstance().getUnsigned(
+        "nodes/latency_report_period");
+    _timer.start();
+}
+
+
+teleop::LatencyMonitor::~LatencyMonitor() {
+    for (auto histogram : _histograms) {
+        delete histogram;
+    }
+}
+
+
+void teleop::LatencyMonitor::recordSince(LatencyStage stage, quint64 stamp) {
+    if (stamp == 0) {
+        return;  // not stamped (e.g. touch disabled)
+    }
+    auto&         clock = LogClock::getInstance();
+    const quint64 now   = clock.toNanoseconds(clock.getTicks());
+    const quint64 then  = clock.toNanoseconds(stamp);
+    _histograms[int(stage)]->record(now > then ? now - then : 0);
+}
+
+
+const teleop::LatencyHistogram&
+teleop::LatencyMonitor::getHistogram(LatencyStage stage) const {
+    return *_histograms[int(stage)];
+}
+
+
+void teleop::LatencyMonitor::poll() {
+    if (_period == 0 || _timer.elapsed() < _period) {
+        return;
+    }
+    _timer.restart();
+    report();
+}
+
+
+void teleop::LatencyMonitor::report() {
+    for (auto histogram : _histograms) {
+        if (histogram->getCount() > 0) {
+            qInfo(logLogger()).noquote() << histogram->getSummary();
+        }
+    }
+}
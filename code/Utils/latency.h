@@ -0,0 +1,87 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <atomic>
+
+
+namespace teleop {
+
+// ==========================================================================
+// Log-bucketed (HDR style) histogram of latencies in [ns].
+// Values below 16ns have their own bucket, then every power of two is split
+// in 16 buckets: the error of a percentile is at most 1/16 (6.25%) up to
+// 2^64ns. The buckets are a fixed array of atomic counters: record() never
+// allocates and can be called from any thread.
+class LatencyHistogram {
+  public:
+    explicit LatencyHistogram(const QString& name);
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram(LatencyHistogram&&)      = delete;
+
+    void           record(quint64 ns);
+    const QString& getName() const;
+    quint64        getCount() const;
+    quint64        getSum() const;  // [ns]
+    quint64        getMax() const;
+    quint64        getPercentile(double percentile) const;  // [ns]
+    QString        getSummary() const;
+
+  private:
+    static const int _subBits     = 4;
+    static const int _subCount    = 1 << _subBits;
+    static const int _bucketCount = (64 - _subBits + 1) * _subCount;
+
+    const QString        _name;
+    std::atomic<quint64> _count;
+    std::atomic<quint64> _sum;
+    std::atomic<quint64> _max;
+    std::atomic<quint64> _buckets[_bucketCount];
+
+    static int     _bucketOf(quint64 ns);
+    static quint64 _upperBoundOf(int bucket);
+};
+
+// ==========================================================================
+// Stages of a touch sample, stamped by TouchAdapter::updateState
+enum class LatencyStage {
+    touchToSupervisor,  // queued TouchNode::request
+    touchToMecaNode,    // + Supervisor + queued requestForRobot
+    requestToCommand,   // MecaNode::onRequest -> MecaAdapter::move*
+    touchToCommand,     // end to end
+    touchToFeedback,    // first robot feedback after the command
+    count
+};
+
+// ==========================================================================
+// Latency of every stage of the pipeline. The summaries (p50, p99, p99.9,
+// max) are reported every nodes/latency_report_period ms by the LogWriter
+// thread and at exit.
+class LatencyMonitor {  // singleton
+  public:
+    static LatencyMonitor& getInstance();
+
+    // stamp: LogClock ticks of the touch sample (or of the request)
+    void recordSince(LatencyStage stage, quint64 stamp);
+    const LatencyHistogram& getHistogram(LatencyStage stage) const;
+
+    void poll();    // LogWriter thread
+    void report();  // e.g. at exit
+
+  private:
+    LatencyHistogram* _histograms[int(LatencyStage::count)];
+    QElapsedTimer     _timer;
+    qint64            _period = 0;  // [ms], 0 = at exit only
+
+    LatencyMonitor();
+    ~LatencyMonitor();
+    LatencyMonitor(const LatencyMonitor&) = delete;
+    void operator=(const LatencyMonitor&) = delete;
+};
+
+}  // namespace teleop
+
+
+#endif  // LATENCY_H
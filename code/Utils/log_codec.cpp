@@ -0,0 +1,209 @@
+#include "log_codec.h"
+#include "log_warning.h"
+#include "logs.h"
+
+#include <QStringList>
+#include <QtEndian>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+// ==========================================================================
+namespace {
+
+quint64 zigzag(qint64 value) {
+    return (quint64(value) << 1) ^ quint64(value >> 63);
+}
+
+
+qint64 unzigzag(quint64 value) {
+    return qint64(value >> 1) ^ -qint64(value & 1);
+}
+
+
+int putVarint(char* dst, quint64 value) {
+    int size = 0;
+    while (value >= 0x80) {
+        dst[size++] = char(value | 0x80);
+        value >>= 7;
+    }
+    dst[size++] = char(value);
+    return size;
+}
+
+
+// false if the varint is not complete in [src, end)
+bool getVarint(const char*& src, const char* end, quint64& value) {
+    value     = 0;
+    int shift = 0;
+    for (const char* p = src; p < end && shift < 64; ++p, shift += 7) {
+        const quint64 byte = quint8(*p);
+        value |= (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            src = p + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// false if the value has no step count: NaN (0), Inf or out of the qint64
+// range (clamped)
+bool quantize(float value, double inverse, qint64& quantized) {
+    const double limit  = 9223372036854775808.0;  // 2^63
+    const double scaled = value * inverse;
+    if (std::isnan(scaled)) {
+        quantized = 0;
+        return false;
+    }
+    if (scaled >= limit) {
+        quantized = std::numeric_limits<qint64>::max();
+        return false;
+    }
+    if (scaled < -limit) {
+        quantized = std::numeric_limits<qint64>::min();
+        return false;
+    }
+    quantized = std::llround(scaled);
+    return true;
+}
+
+}  // namespace
+
+
+// ==========================================================================
+teleop::LogCompressedHeader teleop::makeLogCompressedHeader(
+    const QString& channel, const QString& units, const float* steps) {
+    LogCompressedHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, LOG_COMPRESSED_MAGIC, sizeof(header.magic));
+    header.version    = qToLittleEndian<quint16>(LOG_VERSION);
+    header.headerSize = qToLittleEndian<quint16>(LOG_COMPRESSED_HEADER_SIZE);
+    header.fieldCount = qToLittleEndian<quint16>(LOG_FIELD_COUNT);
+
+    auto name = channel.toUtf8();
+    std::strncpy(header.channel, name.constData(), LOG_NAME_LENGTH - 1);
+    auto unit = units.toUtf8();
+    std::strncpy(header.units, unit.constData(), LOG_UNITS_LENGTH - 1);
+    for (int i = 0; i < LOG_FIELD_COUNT; ++i) {
+        quint32 bits;
+        std::memcpy(&bits, &steps[i], sizeof(bits));
+        bits = qToLittleEndian<quint32>(bits);
+        std::memcpy(&header.steps[i], &bits, sizeof(bits));
+    }
+    return header;
+}
+
+
+QVector<float> teleop::parseLogPrecision(const QString& units,
+                                         const QString& precision,
+                                         float          default_step) {
+    QString        list    = precision;
+    QStringList    entries = list.replace(" ", "").split(",");
+    QStringList    fields  = units.split(",");
+    QVector<float> steps(LOG_FIELD_COUNT, default_step);
+    for (int i = 0; i < LOG_FIELD_COUNT && i < fields.size(); ++i) {
+        for (const auto& entry : entries) {
+            auto pair = entry.split(":");
+            if (pair.size() == 2 && pair[0] == fields[i] &&
+                pair[1].toFloat() > 0) {
+                steps[i] = pair[1].toFloat();
+            }
+        }
+    }
+    return steps;
+}
+
+
+// ==========================================================================
+teleop::LogEncoder::LogEncoder(const float* steps) {
+    for (int i = 0; i < LOG_FIELD_COUNT; ++i) {
+        _inverse[i] = 1.0 / steps[i];
+    }
+}
+
+
+int teleop::LogEncoder::encode(char* dst, quint64 timestamp,
+                               const float* values) {
+    const qint64 delta = qint64(timestamp - _timestamp);
+    int          size  = putVarint(dst, zigzag(delta - _delta));
+    _timestamp         = timestamp;
+    _delta             = delta;
+    for (int i = 0; i < LOG_FIELD_COUNT; ++i) {
+        qint64 quantized;
+        if (!quantize(values[i], _inverse[i], quantized)) {
+            TELEOP_WARN_AGGREGATED(logLogger,
+                                   "compressed log: NaN, Inf or out of "
+                                   "range value not stored",
+                                   values[i]);
+        }
+        // wraps around, like the decoder, when the values are far apart
+        const quint64 delta = quint64(quantized) - quint64(_previous[i]);
+        size += putVarint(dst + size, zigzag(qint64(delta)));
+        _previous[i] = quantized;
+    }
+    _rows++;
+    _bytes += size;
+    return size;
+}
+
+
+quint64 teleop::LogEncoder::getRowCount() const {
+    return _rows;
+}
+
+
+quint64 teleop::LogEncoder::getByteCount() const {
+    return _bytes;
+}
+
+
+// ==========================================================================
+teleop::LogDecoder::LogDecoder(const float* steps) {
+    std::memcpy(_steps, steps, sizeof(_steps));
+}
+
+
+void teleop::LogDecoder::feed(const char* data, int len) {
+    if (_position > 0 && _position * 2 >= _buffer.size()) {
+        _buffer.remove(0, _position);
+        _position = 0;
+    }
+    _buffer.append(data, len);
+}
+
+
+bool teleop::LogDecoder::next(quint64& timestamp, float* values) {
+    const char* src = _buffer.constData() + _position;
+    const char* end = _buffer.constData() + _buffer.size();
+    quint64     raw;
+    qint64      fields[LOG_FIELD_COUNT];
+    // parse the whole row before touching the state
+    if (!getVarint(src, end, raw)) {
+        return false;
+    }
+    const qint64 delta = _delta + unzigzag(raw);
+    for (int i = 0; i < LOG_FIELD_COUNT; ++i) {
+        if (!getVarint(src, end, raw)) {
+            return false;
+        }
+        fields[i] = qint64(quint64(_previous[i]) + quint64(unzigzag(raw)));
+    }
+    _position  = src - _buffer.constData();
+    _delta     = delta;
+    _timestamp = _timestamp + delta;
+    timestamp  = _timestamp;
+    for (int i = 0; i < LOG_FIELD_COUNT; ++i) {
+        _previous[i] = fields[i];
+        values[i]    = float(double(fields[i]) * _steps[i]);
+    }
+    return true;
+}
+
+
+int teleop::LogDecoder::getPendingBytes() const {
+    return _buffer.size() - _position;
+}
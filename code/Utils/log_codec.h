@@ -0,0 +1,95 @@
+#ifndef LOG_CODEC_H
+#define LOG_CODEC_H
+
+#include "log_format.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+
+namespace teleop {
+
+// ==========================================================================
+// Compressed log file (nodes/log_format = compressed): log_<name>.zlog
+//   [LogCompressedHeader: 160 bytes][row 0][row 1]...
+// Rows have a variable size and are written as a stream:
+//   zigzag varint of the timestamp delta-of-delta [ns]
+//   zigzag varint of (round(v / step) - previous) for every field
+// The values are quantized to the step of their field (see
+// nodes/log_precision), so the quantized deltas of a smooth signal usually
+// take one or two bytes. A stream truncated by a crash is decoded up to the
+// last complete row. round(v / step) is clamped to the qint64 range and a NaN
+// is stored as 0; both are reported as aggregated warnings when encoded.
+const char    LOG_COMPRESSED_MAGIC[8] = {'E', 'X', 'T', 'L', 'Z', 'V',
+                                      '\0', '\0'};
+const quint16 LOG_COMPRESSED_HEADER_SIZE = 160;
+const int     LOG_COMPRESSED_MAX_ROW     = 10 * (1 + LOG_FIELD_COUNT);
+
+struct LogCompressedHeader {
+    char    magic[8];
+    quint16 version;
+    quint16 headerSize;  // offset of the first row
+    quint16 fieldCount;
+    quint16 reserved0;
+    char    channel[LOG_NAME_LENGTH];
+    char    units[LOG_UNITS_LENGTH];
+    float   steps[LOG_FIELD_COUNT];  // quantization of each field
+    char    reserved[24];
+};
+static_assert(sizeof(LogCompressedHeader) == LOG_COMPRESSED_HEADER_SIZE,
+              "LogCompressedHeader must be packed to 160 bytes");
+
+LogCompressedHeader makeLogCompressedHeader(const QString& channel,
+                                            const QString& units,
+                                            const float*   steps);
+
+// Quantization step of every field of a channel, from its units and the
+// "unit:step" list of nodes/log_precision (default_step if missing)
+QVector<float> parseLogPrecision(const QString& units,
+                                 const QString& precision,
+                                 float default_step = 1e-4f);
+
+// ==========================================================================
+// Stateful row encoder (a single thread, e.g. the LogWriter)
+class LogEncoder {
+  public:
+    explicit LogEncoder(const float* steps);
+
+    // writes at most LOG_COMPRESSED_MAX_ROW bytes, returns the size
+    int     encode(char* dst, quint64 timestamp, const float* values);
+    quint64 getRowCount() const;
+    quint64 getByteCount() const;
+
+  private:
+    double  _inverse[LOG_FIELD_COUNT];
+    qint64  _previous[LOG_FIELD_COUNT] = {};
+    quint64 _timestamp = 0;
+    qint64  _delta     = 0;
+    quint64 _rows      = 0;
+    quint64 _bytes     = 0;
+};
+
+// ==========================================================================
+// Streaming decoder: feed() any chunk of the stream, then next() until false
+class LogDecoder {
+  public:
+    explicit LogDecoder(const float* steps);
+
+    void feed(const char* data, int len);
+    bool next(quint64& timestamp, float* values);  // false: need more data
+    int  getPendingBytes() const;  // of an incomplete row
+
+  private:
+    float      _steps[LOG_FIELD_COUNT];
+    qint64     _previous[LOG_FIELD_COUNT] = {};
+    quint64    _timestamp = 0;
+    qint64     _delta     = 0;
+    QByteArray _buffer;
+    int        _position = 0;
+};
+
+}  // namespace teleop
+
+
+#endif  // LOG_CODEC_H
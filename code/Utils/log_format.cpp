@@ -0,0 +1,91 @@
+#include "log_format.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+
+// ==========================================================================
+teleop::LogFileHeader teleop::makeLogFileHeader(const QString& channel,
+                                                const QString& units,
+                                                quint16        field_count) {
+    LogFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, LOG_MAGIC, sizeof(header.magic));
+    header.version    = qToLittleEndian<quint16>(LOG_VERSION);
+    header.headerSize = qToLittleEndian<quint16>(LOG_HEADER_SIZE);
+    header.fieldCount = qToLittleEndian<quint16>(field_count);
+    header.rowSize    = qToLittleEndian<quint16>(8 + 4 * field_count);
+
+    auto name = channel.toUtf8();
+    std::strncpy(header.channel, name.constData(), LOG_NAME_LENGTH - 1);
+    auto unit = units.toUtf8();
+    std::strncpy(header.units, unit.constData(), LOG_UNITS_LENGTH - 1);
+    return header;
+}
+
+
+void teleop::encodeLogRow(char* dst, quint64 timestamp, const float* values,
+                          int count) {
+    qToLittleEndian<quint64>(timestamp, dst);
+    for (int i = 0; i < count; ++i) {
+        quint32 bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        qToLittleEndian<quint32>(bits, dst + 8 + 4 * i);
+    }
+}
+
+
+int teleop::formatLogTextRow(char* dst, quint64 timestamp,
+                             const float* values) {
+    int size = formatUnsigned(dst, timestamp);
+    for (int i = 0; i < LOG_FIELD_COUNT; ++i) {
+        dst[size++] = '|';
+        size += formatFloat(dst + size, values[i]);
+    }
+    dst[size++] = '\n';
+    return size;
+}
+
+
+// ==========================================================================
+teleop::LogSessionHeader teleop::makeLogSessionHeader(quint16 channel_count) {
+    LogSessionHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, LOG_SESSION_MAGIC, sizeof(header.magic));
+    header.version      = qToLittleEndian<quint16>(LOG_VERSION);
+    header.channelCount = qToLittleEndian<quint16>(channel_count);
+    header.rowSize      = qToLittleEndian<quint16>(LOG_SESSION_ROW_SIZE);
+    header.fieldCount   = qToLittleEndian<quint16>(LOG_FIELD_COUNT);
+    header.headerSize   = qToLittleEndian<quint32>(
+        sizeof(LogSessionHeader) + channel_count * sizeof(LogChannelEntry));
+    return header;
+}
+
+
+teleop::LogChannelEntry teleop::makeLogChannelEntry(quint16        id,
+                                                    const QString& name,
+                                                    const QString& units,
+                                                    quint16 field_count) {
+    LogChannelEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.id         = qToLittleEndian<quint16>(id);
+    entry.fieldCount = qToLittleEndian<quint16>(field_count);
+    auto name_utf8   = name.toUtf8();
+    std::strncpy(entry.name, name_utf8.constData(), LOG_NAME_LENGTH - 1);
+    auto units_utf8 = units.toUtf8();
+    std::strncpy(entry.units, units_utf8.constData(), LOG_UNITS_LENGTH - 1);
+    return entry;
+}
+
+
+void teleop::encodeLogSessionRow(char* dst, quint64 timestamp, quint32 channel,
+                                 const float* values, int count) {
+    qToLittleEndian<quint64>(timestamp, dst);
+    qToLittleEndian<quint32>(channel, dst + 8);
+    for (int i = 0; i < count; ++i) {
+        quint32 bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        qToLittleEndian<quint32>(bits, dst + 12 + 4 * i);
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+#include "number_format.h"
+
+#include <QString>
+#include <QtGlobal>
+
+
+namespace teleop {
+
+// ==========================================================================
+// Binary log file (nodes/log_format = binary): log_<name>.bin
+//   [LogFileHeader: 128 bytes][row 0][row 1]...
+// Each row is packed little-endian and sorted by timestamp:
+//   quint64 timestamp [ns] | float32 v0 | ... | float32 v(fieldCount-1)
+// The rows end with the file, so a file truncated by a crash is still
+// readable up to the last complete row. A mapped segment is preallocated
+// and zero filled: it sets LOG_FLAG_DATA_SIZE and keeps dataSize equal to
+// the bytes of rows written, which holds after a crash too.
+const char    LOG_MAGIC[8]     = {'E', 'X', 'T', 'L', 'O', 'G', '\0', '\0'};
+const quint16 LOG_VERSION      = 1;
+const quint16 LOG_HEADER_SIZE  = 128;
+const quint16 LOG_FIELD_COUNT  = 6;
+const int     LOG_NAME_LENGTH  = 48;
+const int     LOG_UNITS_LENGTH = 48;
+const quint32 LOG_FLAG_DATA_SIZE = 1;  // dataSize is valid
+
+// All integers are little-endian, strings are NUL padded
+struct LogFileHeader {
+    char    magic[8];
+    quint16 version;
+    quint16 headerSize;  // offset of the first row
+    quint16 fieldCount;  // floats per row
+    quint16 rowSize;     // 8 + 4 * fieldCount
+    char    channel[LOG_NAME_LENGTH];
+    char    units[LOG_UNITS_LENGTH];  // e.g. "mm,mm,mm,deg,deg,deg"
+    quint64 dataSize;  // [bytes] of rows, with LOG_FLAG_DATA_SIZE
+    quint32 flags;
+    char    reserved[4];
+};
+static_assert(sizeof(LogFileHeader) == LOG_HEADER_SIZE,
+              "LogFileHeader must be packed to LOG_HEADER_SIZE bytes");
+
+// Fill a little-endian header for the given channel
+LogFileHeader makeLogFileHeader(const QString& channel, const QString& units,
+                                quint16 field_count = LOG_FIELD_COUNT);
+
+// Append a packed little-endian row to dst (8 + 4 * count bytes)
+void encodeLogRow(char* dst, quint64 timestamp, const float* values,
+                  int count);
+
+// ==========================================================================
+// Text log file (nodes/log_format = text): log_<name>.txt, one line per row
+//   timestamp|v0|v1|v2|v3|v4|v5
+// formatted without allocation (see number_format.h)
+const int LOG_TEXT_ROW_SIZE = (1 + LOG_FIELD_COUNT) * (1 + NUMBER_FORMAT_SIZE);
+
+// Write the row with its '\n' to dst (LOG_TEXT_ROW_SIZE chars at most),
+// return the size
+int formatLogTextRow(char* dst, quint64 timestamp, const float* values);
+
+// ==========================================================================
+// Multiplexed session file (nodes/log_mode = session): log_session.bin
+//   [LogSessionHeader: 32 bytes][LogChannelEntry x channelCount][rows]...
+// Each row is packed little-endian, sorted by timestamp across channels:
+//   quint64 timestamp [ns] | quint32 channel | float32 v0 | ... | float32 v5
+const char    LOG_SESSION_MAGIC[8] = {'E', 'X', 'T', 'S', 'E', 'S', '\0', '\0'};
+const quint16 LOG_SESSION_ROW_SIZE = 12 + 4 * LOG_FIELD_COUNT;
+
+struct LogSessionHeader {
+    char    magic[8];
+    quint16 version;
+    quint16 channelCount;
+    quint16 rowSize;
+    quint16 fieldCount;
+    quint32 headerSize;  // offset of the first row
+    char    reserved[12];
+};
+static_assert(sizeof(LogSessionHeader) == 32,
+              "LogSessionHeader must be packed to 32 bytes");
+
+struct LogChannelEntry {
+    quint16 id;  // value stored in the channel column of the rows
+    quint16 fieldCount;
+    char    name[LOG_NAME_LENGTH];
+    char    units[LOG_UNITS_LENGTH];
+    char    reserved[4];
+};
+static_assert(sizeof(LogChannelEntry) == 104,
+              "LogChannelEntry must be packed to 104 bytes");
+
+LogSessionHeader makeLogSessionHeader(quint16 channel_count);
+
+LogChannelEntry makeLogChannelEntry(quint16 id, const QString& name,
+                                    const QString& units,
+                                    quint16 field_count = LOG_FIELD_COUNT);
+
+// Append a packed little-endian session row to dst (12 + 4 * count bytes)
+void encodeLogSessionRow(char* dst, quint64 timestamp, quint32 channel,
+                         const float* values, int count);
+
+}  // namespace teleop
+
+
+#endif  // LOG_FORMAT_H
@@ -0,0 +1,49 @@
+#ifndef LOG_LEVEL_H
+#define LOG_LEVEL_H
+
+#include <QLoggingCategory>
+
+
+// ==========================================================================
+// Logging with a compile-time minimum level per category.
+// Every category declares the lowest level that is compiled in, next to its
+// Q_DECLARE_LOGGING_CATEGORY:
+//     Q_DECLARE_LOGGING_CATEGORY(logGenerators)
+//     TELEOP_LOG_MIN_LEVEL(logGenerators, TELEOP_LOG_LEVEL)
+// and logs with TELEOP_DEBUG(logGenerators) << ... (same for INFO, WARNING).
+// Below the minimum the statement is a constant false loop that the compiler
+// removes: arguments are not evaluated and nothing is formatted. Above it,
+// the statement is qCDebug and friends, so the QLoggingCategory rules of
+// main.cpp still switch the category at runtime (and, unlike qDebug(cat),
+// the arguments are only evaluated when enabled).
+// TELEOP_LOG_LEVEL is info in release builds (QT_NO_DEBUG) and debug
+// otherwise; override it with DEFINES += TELEOP_LOG_LEVEL=... in qmake.
+#define TELEOP_LOG_LEVEL_DEBUG    0
+#define TELEOP_LOG_LEVEL_INFO     1
+#define TELEOP_LOG_LEVEL_WARNING  2
+#define TELEOP_LOG_LEVEL_CRITICAL 3
+
+#ifndef TELEOP_LOG_LEVEL
+#ifdef QT_NO_DEBUG
+#define TELEOP_LOG_LEVEL TELEOP_LOG_LEVEL_INFO
+#else
+#define TELEOP_LOG_LEVEL TELEOP_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#define TELEOP_LOG_MIN_LEVEL(category, level) \
+    constexpr int category##_minLevel = (level);
+
+#define TELEOP_LOG_IF(category, level)                                   \
+    for (bool teleop_log_on = (level) >= category##_minLevel; teleop_log_on; \
+         teleop_log_on      = false)
+
+#define TELEOP_DEBUG(category) \
+    TELEOP_LOG_IF(category, TELEOP_LOG_LEVEL_DEBUG) qCDebug(category)
+#define TELEOP_INFO(category) \
+    TELEOP_LOG_IF(category, TELEOP_LOG_LEVEL_INFO) qCInfo(category)
+#define TELEOP_WARNING(category) \
+    TELEOP_LOG_IF(category, TELEOP_LOG_LEVEL_WARNING) qCWarning(category)
+
+
+#endif  // LOG_LEVEL_H
@@ -0,0 +1,234 @@
+#include "log_reader.h"
+
+#include <QDebug>
+#include <QtEndian>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Q_LOGGING_CATEGORY(logLogReader, "LogReader")
+
+
+// ==========================================================================
+teleop::LogReader::~LogReader() {
+    close();
+}
+
+
+bool teleop::LogReader::open(const QString& path) {
+    close();
+    _fd = ::open(path.toLocal8Bit().constData(), O_RDONLY);
+    if (_fd < 0) {
+        return _fail("Cannot open " + path + ": " + strerror(errno));
+    }
+    struct stat info;
+    if (fstat(_fd, &info) != 0) {
+        return _fail("Cannot stat " + path + ": " + strerror(errno));
+    }
+    _size = info.st_size;
+    if (_size < LOG_HEADER_SIZE) {
+        return _fail(path + " is too small to be a binary log");
+    }
+    void* map = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _fd, 0);
+    if (map == MAP_FAILED) {
+        return _fail("Cannot mmap " + path + ": " + strerror(errno));
+    }
+    _map = static_cast<const char*>(map);
+
+    // Header
+    if (std::memcmp(_map, LOG_MAGIC, sizeof(LOG_MAGIC)) == 0) {
+        if (!_readFileHeader(path)) {
+            return false;
+        }
+    } else if (std::memcmp(_map, LOG_SESSION_MAGIC,
+                           sizeof(LOG_SESSION_MAGIC)) == 0) {
+        if (!_readSessionHeader(path)) {
+            return false;
+        }
+    } else {
+        return _fail(path + " is not a binary log (bad magic)");
+    }
+    // an incomplete last row (crash while writing) is ignored; a mapped
+    // segment left by a crash is zero filled after its dataSize
+    _rowCount = qMin(_size - _headerSize, _dataSize) / _rowSize;
+    return true;
+}
+
+
+void teleop::LogReader::close() {
+    if (_map) {
+        munmap(const_cast<char*>(_map), _size);
+        _map = nullptr;
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    _size     = 0;
+    _dataSize = ~quint64(0);
+    _rowCount = 0;
+    _session  = false;
+    _channels.clear();
+    _units.clear();
+}
+
+
+bool teleop::LogReader::isOpen() const {
+    return _map != nullptr;
+}
+
+
+const QString& teleop::LogReader::getErrorString() const {
+    return _error;
+}
+
+
+bool teleop::LogReader::isSession() const {
+    return _session;
+}
+
+
+int teleop::LogReader::getChannelCount() const {
+    return _channels.size();
+}
+
+
+int teleop::LogReader::findChannel(const QString& name) const {
+    return _channels.indexOf(name);
+}
+
+
+QString teleop::LogReader::getChannel(int channel) const {
+    return _channels.value(channel);
+}
+
+
+QString teleop::LogReader::getUnits(int channel) const {
+    return _units.value(channel);
+}
+
+
+int teleop::LogReader::getFieldCount() const {
+    return _fieldCount;
+}
+
+
+int teleop::LogReader::getRowSize() const {
+    return _rowSize;
+}
+
+
+quint64 teleop::LogReader::getRowCount() const {
+    return _rowCount;
+}
+
+
+const char* teleop::LogReader::getRowData(quint64 row) const {
+    return _map + _headerSize + row * _rowSize;
+}
+
+
+quint64 teleop::LogReader::getTimestamp(quint64 row) const {
+    return qFromLittleEndian<quint64>(getRowData(row));
+}
+
+
+quint32 teleop::LogReader::getRowChannel(quint64 row) const {
+    if (!_session) {
+        return 0;
+    }
+    return qFromLittleEndian<quint32>(getRowData(row) + 8);
+}
+
+
+float teleop::LogReader::getValue(quint64 row, int field) const {
+    quint32 bits = qFromLittleEndian<quint32>(getRowData(row) + _valueOffset +
+                                              4 * field);
+    float   value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+
+quint64 teleop::LogReader::lowerBound(quint64 ts) const {
+    quint64 first = 0;
+    quint64 count = _rowCount;
+    while (count > 0) {
+        quint64 step = count / 2;
+        quint64 mid  = first + step;
+        if (getTimestamp(mid) < ts) {
+            first = mid + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+
+bool teleop::LogReader::_fail(const QString& error) {
+    _error = error;
+    qWarning(logLogReader()) << error;
+    close();
+    return false;
+}
+
+
+bool teleop::LogReader::_readFileHeader(const QString& path) {
+    LogFileHeader header;
+    std::memcpy(&header, _map, sizeof(header));
+    if (qFromLittleEndian<quint16>(header.version) != LOG_VERSION) {
+        return _fail(path + " has an unsupported version");
+    }
+    _headerSize  = qFromLittleEndian<quint16>(header.headerSize);
+    _fieldCount  = qFromLittleEndian<quint16>(header.fieldCount);
+    _rowSize     = qFromLittleEndian<quint16>(header.rowSize);
+    _valueOffset = 8;
+    if (_rowSize != 8 + 4 * _fieldCount || _headerSize > _size) {
+        return _fail(path + " has an inconsistent header");
+    }
+    if (qFromLittleEndian<quint32>(header.flags) & LOG_FLAG_DATA_SIZE) {
+        _dataSize = qFromLittleEndian<quint64>(header.dataSize);
+    }
+    _channels << QString::fromUtf8(header.channel,
+                                   strnlen(header.channel, LOG_NAME_LENGTH));
+    _units << QString::fromUtf8(header.units,
+                                strnlen(header.units, LOG_UNITS_LENGTH));
+    return true;
+}
+
+
+bool teleop::LogReader::_readSessionHeader(const QString& path) {
+    LogSessionHeader header;
+    std::memcpy(&header, _map, sizeof(header));
+    if (qFromLittleEndian<quint16>(header.version) != LOG_VERSION) {
+        return _fail(path + " has an unsupported version");
+    }
+    int channel_count = qFromLittleEndian<quint16>(header.channelCount);
+    _session          = true;
+    _headerSize       = qFromLittleEndian<quint32>(header.headerSize);
+    _fieldCount       = qFromLittleEndian<quint16>(header.fieldCount);
+    _rowSize          = qFromLittleEndian<quint16>(header.rowSize);
+    _valueOffset      = 12;
+    if (_rowSize != 12 + 4 * _fieldCount || _headerSize > _size ||
+        _headerSize != sizeof(LogSessionHeader) +
+                           channel_count * sizeof(LogChannelEntry)) {
+        return _fail(path + " has an inconsistent header");
+    }
+    const char* table = _map + sizeof(LogSessionHeader);
+    for (int i = 0; i < channel_count; ++i) {
+        LogChannelEntry entry;
+        std::memcpy(&entry, table + i * sizeof(LogChannelEntry),
+                    sizeof(entry));
+        _channels << QString::fromUtf8(entry.name,
+                                       strnlen(entry.name, LOG_NAME_LENGTH));
+        _units << QString::fromUtf8(entry.units,
+                                    strnlen(entry.units, LOG_UNITS_LENGTH));
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+#ifndef LOG_READER_H
+#define LOG_READER_H
+
+#include "log_format.h"
+
+#include <QLoggingCategory>
+#include <QString>
+#include <QStringList>
+
+Q_DECLARE_LOGGING_CATEGORY(logLogReader)
+
+
+namespace teleop {
+
+// ==========================================================================
+// Read-only view of a binary log file or of a session file (see
+// log_format.h). The file is memory mapped: opening is O(1) and only the
+// pages touched by the requested rows are read from disk. Rows are sorted by
+// timestamp, so a time range is found with a binary search.
+// A single-channel log is read as a session with the only channel 0.
+class LogReader {
+  public:
+    LogReader() = default;
+    LogReader(const LogReader&) = delete;
+    LogReader(LogReader&&)      = delete;
+    ~LogReader();
+
+    bool           open(const QString& path);  // false on error
+    void           close();
+    bool           isOpen() const;
+    const QString& getErrorString() const;
+
+    bool        isSession() const;
+    int         getChannelCount() const;
+    int         findChannel(const QString& name) const;  // -1 if missing
+    QString     getChannel(int channel = 0) const;
+    QString     getUnits(int channel = 0) const;
+    int         getFieldCount() const;
+    int         getRowSize() const;
+    quint64     getRowCount() const;
+    const char* getRowData(quint64 row) const;  // packed little-endian row
+    quint64     getTimestamp(quint64 row) const;
+    quint32     getRowChannel(quint64 row) const;
+    float       getValue(quint64 row, int field) const;
+
+    // index of the first row with timestamp >= ts (getRowCount() if none)
+    quint64 lowerBound(quint64 ts) const;
+
+  private:
+    int         _fd          = -1;
+    const char* _map         = nullptr;
+    quint64     _size        = 0;
+    bool        _session     = false;
+    QStringList _channels;
+    QStringList _units;
+    quint64     _headerSize  = 0;
+    quint64     _dataSize    = ~quint64(0);  // [bytes] of rows, if stored
+    int         _valueOffset = 8;  // 12 in a session (channel column)
+    int         _fieldCount  = 0;
+    int         _rowSize     = 0;
+    quint64     _rowCount    = 0;
+    QString     _error;
+
+    bool _fail(const QString& error);
+    bool _readFileHeader(const QString& path);
+    bool _readSessionHeader(const QString& path);
+};
+
+}  // namespace teleop
+
+
+#endif  // LOG_READER_H
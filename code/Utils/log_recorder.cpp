@@ -0,0 +1,143 @@
+#include "log_recorder.h"
+#include "log_format.h"
+#include "logs.h"
+#include "settings.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+
+
+// ==========================================================================
+namespace {
+
+// Only a lock-free atomic may be touched by the signal handler
+std::atomic<bool> dumpRequested(false);
+
+void onDumpSignal(int) {
+    dumpRequested.store(true, std::memory_order_relaxed);
+}
+
+struct RecorderEntry {
+    quint64 timestamp;
+    quint32 channel;
+    float   values[teleop::LOG_FIELD_COUNT];
+};
+
+}  // namespace
+
+
+// ==========================================================================
+teleop::FlightRecorder& teleop::FlightRecorder::getInstance() {
+    static FlightRecorder instance;
+    return instance;
+}
+
+
+void teleop::FlightRecorder::attach(Logger* logger) {
+    _mutex.lock();
+    _loggers.append(logger);
+    _mutex.unlock();
+}
+
+
+void teleop::FlightRecorder::detach(Logger* logger) {
+    _mutex.lock();
+    _loggers.removeAll(logger);
+    _mutex.unlock();
+}
+
+
+void teleop::FlightRecorder::installSignalHandler() {
+    struct sigaction action;
+    action.sa_handler = onDumpSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGUSR1, &action, nullptr) != 0) {
+        qWarning(logLogger()) << "FlightRecorder: cannot install SIGUSR1";
+    }
+}
+
+
+void teleop::FlightRecorder::dump(const QString& reason) {
+    _mutex.lock();
+    if (_loggers.isEmpty() ||
+        (_lastDump.isValid() && _lastDump.elapsed() < 1000)) {
+        _mutex.unlock();
+        return;
+    }
+    _lastDump.start();
+
+    // Snapshot and merge the history of every channel
+    QVector<RecorderEntry> entries;
+    QVector<LogRecord>     history;
+    for (int i = 0; i < _loggers.size(); ++i) {
+        history.clear();
+        _loggers[i]->readHistory(history);
+        for (const auto& record : history) {
+            RecorderEntry entry;
+            entry.timestamp = record.timestamp;
+            entry.channel   = i;
+            std::copy(record.values, record.values + LOG_FIELD_COUNT,
+                      entry.values);
+            entries.append(entry);
+        }
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const RecorderEntry& a, const RecorderEntry& b) {
+                         return a.timestamp < b.timestamp;
+                     });
+
+    QByteArray output;
+    auto       header = makeLogSessionHeader(_loggers.size());
+    output.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int i = 0; i < _loggers.size(); ++i) {
+        auto channel = makeLogChannelEntry(i, _loggers[i]->getName(),
+                                           _loggers[i]->getUnits());
+        output.append(reinterpret_cast<const char*>(&channel),
+                      sizeof(channel));
+    }
+    char row[LOG_SESSION_ROW_SIZE];
+    for (const auto& entry : entries) {
+        encodeLogSessionRow(row, entry.timestamp, entry.channel, entry.values,
+                            LOG_FIELD_COUNT);
+        output.append(row, sizeof(row));
+    }
+    _mutex.unlock();
+
+    QString dir_path = SettingsManager::getInstance().getDirectoryPath() +
+                       "/logs/";
+    QDir dir;
+    if (!dir.exists(dir_path)) {
+        dir.mkpath(dir_path);
+    }
+    QFile file(dir_path + "recorder_" +
+               QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss") +
+               "_" + reason + ".bin");
+    if (!file.open(QFile::WriteOnly) || file.write(output) != output.size()) {
+        qWarning(logLogger()) << "FlightRecorder: cannot write"
+                              << file.fileName() << file.errorString();
+        return;
+    }
+    file.close();
+    qWarning(logLogger()) << "FlightRecorder:" << reason << "->"
+                          << file.fileName() << "(" << entries.size()
+                          << "records )";
+}
+
+
+void teleop::FlightRecorder::requestDump() {
+    dumpRequested.store(true, std::memory_order_relaxed);
+}
+
+
+void teleop::FlightRecorder::poll() {
+    if (dumpRequested.exchange(false, std::memory_order_relaxed)) {
+        dump("signal");
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef LOG_RECORDER_H
+#define LOG_RECORDER_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+
+namespace teleop {
+
+class Logger;
+
+// ==========================================================================
+// Flight recorder (nodes/log_mode = recorder).
+// Every Logger keeps the last nodes/log_recorder_size records in a fixed
+// circular history and nothing is written during the run. dump() merges the
+// history of all the Loggers in logs/recorder_<date>_<reason>.bin, a session
+// file (see log_format.h) readable with log_converter.
+// Dumps are triggered by the faults (MecaAdapter/TouchAdapter abort), by the
+// quit button and by SIGUSR1.
+class FlightRecorder {  // singleton
+  public:
+    static FlightRecorder& getInstance();
+
+    void attach(Logger* logger);
+    void detach(Logger* logger);
+
+    // SIGUSR1 -> requestDump()
+    void installSignalHandler();
+
+    // Dump now from the calling thread. Dumps closer than 1s are merged.
+    void dump(const QString& reason);
+    // Async-signal-safe: the dump is done by the next poll()
+    void requestDump();
+    void poll();  // LogWriter thread
+
+  private:
+    QMutex           _mutex;
+    QVector<Logger*> _loggers;
+    QElapsedTimer    _lastDump;
+
+    FlightRecorder() = default;
+    FlightRecorder(const FlightRecorder&) = delete;
+    void operator=(const FlightRecorder&) = delete;
+};
+
+}  // namespace teleop
+
+
+#endif  // LOG_RECORDER_H
@@ -0,0 +1,117 @@
+#include "log_segment.h"
+#include "log_format.h"
+#include "logs.h"
+
+#include <QDebug>
+#include <QtEndian>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+// ==========================================================================
+teleop::LogSegment* teleop::LogSegment::create(const QString&    path,
+                                               quint64           size,
+                                               const QByteArray& header) {
+    const quint64 page = sysconf(_SC_PAGESIZE);
+    size               = qMax(size, quint64(header.size()) + page);
+    size               = (size + page - 1) / page * page;
+
+    int fd = ::open(path.toLocal8Bit().constData(),
+                    O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        qWarning(logLogger()) << "Cannot create segment" << path << ":"
+                              << strerror(errno);
+        return nullptr;
+    }
+    // reserve the blocks now: no ENOSPC/SIGBUS while writing the mapping
+    int error = posix_fallocate(fd, 0, size);
+    if (error != 0) {
+        qWarning(logLogger()) << "Cannot allocate segment" << path << ":"
+                              << strerror(error);
+        ::close(fd);
+        return nullptr;
+    }
+    void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (map == MAP_FAILED) {
+        qWarning(logLogger()) << "Cannot mmap segment" << path << ":"
+                              << strerror(errno);
+        ::close(fd);
+        return nullptr;
+    }
+    // MAP_POPULATE only reads the pages: write each one so that the first
+    // append on it does not take a write fault
+    char* data = static_cast<char*>(map);
+    for (quint64 offset = 0; offset < size; offset += page) {
+        data[offset] = 0;
+    }
+
+    auto segment   = new LogSegment();
+    segment->_path = path;
+    segment->_fd   = fd;
+    segment->_map  = data;
+    segment->_size = size;
+    segment->append(header.constData(), header.size());
+    segment->_headerSize = header.size();
+    qToLittleEndian<quint32>(LOG_FLAG_DATA_SIZE,
+                             data + offsetof(LogFileHeader, flags));
+    qToLittleEndian<quint64>(0, data + offsetof(LogFileHeader, dataSize));
+    return segment;
+}
+
+
+teleop::LogSegment::~LogSegment() {
+    close();
+}
+
+
+bool teleop::LogSegment::append(const char* data, unsigned len) {
+    if (_used + len > _size) {
+        return false;
+    }
+    std::memcpy(_map + _used, data, len);
+    _used += len;
+    if (_headerSize) {
+        // after the row: a crash never counts bytes that are not there
+        qToLittleEndian<quint64>(_used - _headerSize,
+                                 _map + offsetof(LogFileHeader, dataSize));
+    }
+    return true;
+}
+
+
+void teleop::LogSegment::close() {
+    if (_map) {
+        munmap(_map, _size);
+        _map = nullptr;
+    }
+    if (_fd >= 0) {
+        if (ftruncate(_fd, _used) != 0) {
+            qWarning(logLogger()) << "Cannot truncate segment" << _path << ":"
+                                  << strerror(errno);
+        }
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+
+void teleop::LogSegment::remove() {
+    close();
+    ::unlink(_path.toLocal8Bit().constData());
+}
+
+
+quint64 teleop::LogSegment::getUsed() const {
+    return _used;
+}
+
+
+const QString& teleop::LogSegment::getPath() const {
+    return _path;
+}
@@ -0,0 +1,50 @@
+#ifndef LOG_SEGMENT_H
+#define LOG_SEGMENT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+
+namespace teleop {
+
+// ==========================================================================
+// Preallocated file mapped in memory (MAP_SHARED).
+// Every byte copied with append() is in the page cache as soon as append()
+// returns, so it survives a crash, abort() or exit() of the process.
+// The file is allocated and all its pages are faulted in by create(), so
+// append() never enters the kernel: it is a bounds check and a memcpy.
+// The header is a LogFileHeader: append() keeps its dataSize equal to the
+// bytes appended after it (LOG_FLAG_DATA_SIZE), so the rows end there even
+// when a crash leaves the zero filled tail. close() truncates the file to
+// the bytes really used.
+class LogSegment {
+  public:
+    // nullptr on failure. The header is written at the start of the file.
+    static LogSegment* create(const QString& path, quint64 size,
+                              const QByteArray& header);
+    LogSegment(const LogSegment&) = delete;
+    LogSegment(LogSegment&&)      = delete;
+    ~LogSegment();  // calls close()
+
+    bool           append(const char* data, unsigned len);  // false if full
+    void           close();
+    void           remove();  // close and delete the file
+    quint64        getUsed() const;
+    const QString& getPath() const;
+
+  private:
+    LogSegment() = default;
+
+    QString _path;
+    int     _fd   = -1;
+    char*   _map  = nullptr;
+    quint64 _size       = 0;
+    quint64 _used       = 0;
+    quint64 _headerSize = 0;
+};
+
+}  // namespace teleop
+
+
+#endif  // LOG_SEGMENT_H
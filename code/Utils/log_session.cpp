@@ -0,0 +1,147 @@
+#include "log_session.h"
+#include "logs.h"
+#include "settings.h"
+
+#include <QDebug>
+#include <QDir>
+
+#include <algorithm>
+
+
+// ==========================================================================
+teleop::LogSession& teleop::LogSession::getInstance() {
+    static LogSession instance;
+    return instance;
+}
+
+
+quint32 teleop::LogSession::registerChannel(const QString& name,
+                                            const QString& units) {
+    _mutex.lock();
+    if (_closed) {
+        // reopening would truncate the session already written
+        qWarning(logLogger()) << "LogSession: channel" << name
+                              << "registered after the session closed,"
+                              << "not logged";
+        _mutex.unlock();
+        return LOG_SESSION_NO_CHANNEL;
+    }
+    if (_active == 0 && !_file.isOpen()) {
+        _open();
+    }
+    if (_headerWritten) {
+        qWarning(logLogger()) << "LogSession: channel" << name
+                              << "registered after the first record";
+    }
+    Channel channel;
+    channel.name  = name;
+    channel.units = units;
+    _channels.append(channel);
+    _active++;
+    quint32 id = _channels.size() - 1;
+    _mutex.unlock();
+    return id;
+}
+
+
+void teleop::LogSession::unregisterChannel(quint32 channel) {
+    if (channel == LOG_SESSION_NO_CHANNEL) {
+        return;
+    }
+    _mutex.lock();
+    _channels[channel].active = false;
+    _active--;
+    if (_active == 0) {
+        _write(true);
+        _file.close();
+        _closed = true;
+    }
+    _mutex.unlock();
+}
+
+
+bool teleop::LogSession::isChannelTableWritten() {
+    _mutex.lock();
+    const bool written = _headerWritten;
+    _mutex.unlock();
+    return written;
+}
+
+
+void teleop::LogSession::collect(quint32 channel, const LogRecord& record) {
+    if (channel == LOG_SESSION_NO_CHANNEL) {
+        return;
+    }
+    Entry entry;
+    entry.timestamp = record.timestamp;
+    entry.channel   = channel;
+    std::copy(record.values, record.values + LOG_FIELD_COUNT, entry.values);
+    _mutex.lock();
+    _pending.append(entry);
+    _mutex.unlock();
+}
+
+
+void teleop::LogSession::write(bool all) {
+    _mutex.lock();
+    _write(all);
+    _mutex.unlock();
+}
+
+
+void teleop::LogSession::_open() {
+    auto&   settings = SettingsManager::getInstance();
+    QString dir_path = settings.getDirectoryPath() + "/logs/";
+    QDir    dir;
+    if (!dir.exists(dir_path)) {
+        dir.mkpath(dir_path);
+    }
+    _slack = quint64(settings.getUnsigned("nodes/log_session_slack")) *
+             1000000;
+    _file.setFileName(dir_path + "log_session.bin");
+    if (!_file.open(QFile::WriteOnly)) {
+        qWarning(logLogger()) << "LogSession: cannot open" << _file.fileName()
+                              << _file.errorString();
+    }
+    _pending.reserve(8192);
+}
+
+
+void teleop::LogSession::_write(bool all) {
+    if (_pending.isEmpty() || !_file.isOpen()) {
+        return;
+    }
+    if (!_headerWritten) {
+        auto header = makeLogSessionHeader(_channels.size());
+        _output.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (int i = 0; i < _channels.size(); ++i) {
+            auto entry = makeLogChannelEntry(i, _channels[i].name,
+                                             _channels[i].units);
+            _output.append(reinterpret_cast<const char*>(&entry),
+                           sizeof(entry));
+        }
+        _headerWritten = true;
+    }
+
+    // each channel is already in order: a stable sort merges them
+    std::stable_sort(_pending.begin(), _pending.end(),
+                     [](const Entry& a, const Entry& b) {
+                         return a.timestamp < b.timestamp;
+                     });
+    const quint64 now    = LogClock::getInstance().getNanoseconds();
+    const quint64 cutoff = all ? now : (now > _slack ? now - _slack : 0);
+    int           count  = 0;
+    char          row[LOG_SESSION_ROW_SIZE];
+    for (; count < _pending.size(); ++count) {
+        const Entry& entry = _pending[count];
+        if (!all && entry.timestamp > cutoff) {
+            break;
+        }
+        encodeLogSessionRow(row, entry.timestamp, entry.channel, entry.values,
+                            LOG_FIELD_COUNT);
+        _output.append(row, sizeof(row));
+    }
+    _pending.erase(_pending.begin(), _pending.begin() + count);
+    _file.write(_output);
+    _output.clear();
+}
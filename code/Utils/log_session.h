@@ -0,0 +1,76 @@
+#ifndef LOG_SESSION_H
+#define LOG_SESSION_H
+
+#include "log_format.h"
+
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+
+namespace teleop {
+
+struct LogRecord;
+
+// Returned by LogSession::registerChannel once the session is closed: the
+// records of that channel are dropped
+const quint32 LOG_SESSION_NO_CHANNEL = ~quint32(0);
+
+// ==========================================================================
+// Single multiplexed log of the whole session (nodes/log_mode = session).
+// Every Logger registers its channel once at startup and then hands its
+// records to the session from the LogWriter thread. Records of all channels
+// are merged by LogClock timestamp and written to log_session.bin (see
+// log_format.h) with a single write per LogWriter period.
+// Records younger than nodes/log_session_slack ms are held back, so that a
+// late record of another thread can still be placed in order.
+class LogSession {  // singleton
+  public:
+    static LogSession& getInstance();
+
+    // The channel table is written with the first records: channels must be
+    // registered before that (i.e. at startup). Once the last channel is
+    // unregistered the session is over and later channels are refused.
+    quint32 registerChannel(const QString& name, const QString& units);
+    void    unregisterChannel(quint32 channel);  // last one closes the file
+    bool    isChannelTableWritten();  // later channels would be missing
+
+    // LogWriter thread (or owner of the channel after LogWriter::detach)
+    void collect(quint32 channel, const LogRecord& record);
+    void write(bool all = false);  // all: ignore the slack
+
+  private:
+    struct Channel {
+        QString name;
+        QString units;
+        bool    active = true;
+    };
+    struct Entry {
+        quint64 timestamp;
+        quint32 channel;
+        float   values[LOG_FIELD_COUNT];
+    };
+
+    QMutex           _mutex;
+    QFile            _file;
+    bool             _headerWritten = false;
+    bool             _closed        = false;  // never reopened
+    unsigned         _active        = 0;
+    quint64          _slack         = 0;  // [ns]
+    QVector<Channel> _channels;
+    QVector<Entry>   _pending;
+    QByteArray       _output;
+
+    LogSession() = default;
+    LogSession(const LogSession&) = delete;
+    void operator=(const LogSession&) = delete;
+
+    void _open();
+    void _write(bool all);
+};
+
+}  // namespace teleop
+
+
+#endif  // LOG_SESSION_H
@@ -0,0 +1,145 @@
+#include "log_warning.h"
+#include "settings.h"
+
+#include <QDebug>
+#include <QFileInfo>
+
+#include <limits>
+
+
+// ==========================================================================
+namespace {
+
+void storeMin(std::atomic<float>& target, float value) {
+    float current = target.load(std::memory_order_relaxed);
+    while (value < current &&
+           !target.compare_exchange_weak(current, value,
+                                         std::memory_order_relaxed)) {
+    }
+}
+
+
+void storeMax(std::atomic<float>& target, float value) {
+    float current = target.load(std::memory_order_relaxed);
+    while (value > current &&
+           !target.compare_exchange_weak(current, value,
+                                         std::memory_order_relaxed)) {
+    }
+}
+
+}  // namespace
+
+
+// ==========================================================================
+teleop::WarningCounter::WarningCounter(Category category, const QString& site,
+                                       quint64 period)
+    : _category(category), _site(site), _period(period), _lastReport(0),
+      _total(0), _count(0), _min(std::numeric_limits<float>::max()),
+      _max(std::numeric_limits<float>::lowest()),
+      _totalMin(std::numeric_limits<float>::max()),
+      _totalMax(std::numeric_limits<float>::lowest()) {
+}
+
+
+void teleop::WarningCounter::add(float value) {
+    _total.fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    storeMin(_min, value);
+    storeMax(_max, value);
+    storeMin(_totalMin, value);
+    storeMax(_totalMax, value);
+
+    // the first warning is reported at once, then one line per period
+    const quint64 now  = WarningRegistry::getInstance().getNanoseconds();
+    quint64       last = _lastReport.load(std::memory_order_relaxed);
+    if ((last == 0 || now - last >= _period) &&
+        _lastReport.compare_exchange_strong(last, now,
+                                            std::memory_order_relaxed)) {
+        report();
+    }
+}
+
+
+void teleop::WarningCounter::report() {
+    quint64 count = _count.exchange(0, std::memory_order_relaxed);
+    if (count == 0) {
+        return;
+    }
+    float min = _min.exchange(std::numeric_limits<float>::max(),
+                              std::memory_order_relaxed);
+    float max = _max.exchange(std::numeric_limits<float>::lowest(),
+                              std::memory_order_relaxed);
+    qWarning(_category()).nospace()
+        << _site << ": " << count << " times, value in [" << min << ", "
+        << max << "] (total " << _total.load(std::memory_order_relaxed)
+        << ")";
+}
+
+
+teleop::WarningCounter::Stats teleop::WarningCounter::getStats() const {
+    Stats stats;
+    stats.site  = _site;
+    stats.total = _total.load(std::memory_order_relaxed);
+    stats.min   = _totalMin.load(std::memory_order_relaxed);
+    stats.max   = _totalMax.load(std::memory_order_relaxed);
+    return stats;
+}
+
+
+// ==========================================================================
+teleop::WarningRegistry& teleop::WarningRegistry::getInstance() {
+    static WarningRegistry instance;
+    return instance;
+}
+
+
+teleop::WarningRegistry::WarningRegistry() {
+    _timer.start();
+    _period = quint64(SettingsManager::getInstance().getUnsigned(
+                  "nodes/warning_period")) *
+              1000000;
+}
+
+
+teleop::WarningRegistry::~WarningRegistry() {
+    qDeleteAll(_counters);
+}
+
+
+teleop::WarningCounter& teleop::WarningRegistry::getCounter(
+    WarningCounter::Category category, const char* file, int line,
+    const char* site) {
+    auto label = QString("%1 (%2:%3)")
+                     .arg(site, QFileInfo(file).fileName())
+                     .arg(line);
+    auto counter = new WarningCounter(category, label, _period);
+    _mutex.lock();
+    _counters.append(counter);
+    _mutex.unlock();
+    return *counter;
+}
+
+
+quint64 teleop::WarningRegistry::getNanoseconds() const {
+    return _timer.nsecsElapsed();
+}
+
+
+QVector<teleop::WarningCounter::Stats> teleop::WarningRegistry::getStats() {
+    QVector<WarningCounter::Stats> stats;
+    _mutex.lock();
+    for (auto counter : _counters) {
+        stats.append(counter->getStats());
+    }
+    _mutex.unlock();
+    return stats;
+}
+
+
+void teleop::WarningRegistry::report() {
+    _mutex.lock();
+    for (auto counter : _counters) {
+        counter->report();
+    }
+    _mutex.unlock();
+}
@@ -0,0 +1,92 @@
+#ifndef LOG_WARNING_H
+#define LOG_WARNING_H
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+
+namespace teleop {
+
+// ==========================================================================
+// Aggregated warning of a single call site (see TELEOP_WARN_AGGREGATED).
+// add() only updates atomic counters: the summary line "count, min, max"
+// is formatted at most once every nodes/warning_period ms, by the thread
+// that crosses the period. Safe from any thread.
+class WarningCounter {
+  public:
+    using Category = const QLoggingCategory& (*)();
+
+    struct Stats {
+        QString site;
+        quint64 total;
+        float   min;  // over the whole run
+        float   max;
+    };
+
+    WarningCounter(Category category, const QString& site, quint64 period);
+    WarningCounter(const WarningCounter&) = delete;
+    WarningCounter(WarningCounter&&)      = delete;
+
+    void  add(float value);
+    void  report();  // summary of the current window, if any
+    Stats getStats() const;
+
+  private:
+    const Category       _category;
+    const QString        _site;
+    const quint64        _period;  // [ns]
+    std::atomic<quint64> _lastReport;
+    std::atomic<quint64> _total;
+    std::atomic<quint64> _count;  // current window
+    std::atomic<float>   _min;
+    std::atomic<float>   _max;
+    std::atomic<float>   _totalMin;
+    std::atomic<float>   _totalMax;
+};
+
+// ==========================================================================
+class WarningRegistry {  // singleton
+  public:
+    static WarningRegistry& getInstance();
+
+    // once per call site (the macro keeps it in a static)
+    WarningCounter& getCounter(WarningCounter::Category category,
+                               const char* file, int line,
+                               const char* site);
+    quint64 getNanoseconds() const;
+
+    QVector<WarningCounter::Stats> getStats();
+    void                           report();  // pending windows, e.g. at exit
+
+  private:
+    QMutex                   _mutex;
+    QElapsedTimer            _timer;
+    quint64                  _period = 0;  // [ns]
+    QVector<WarningCounter*> _counters;
+
+    WarningRegistry();
+    ~WarningRegistry();
+    WarningRegistry(const WarningRegistry&) = delete;
+    void operator=(const WarningRegistry&) = delete;
+};
+
+}  // namespace teleop
+
+// ==========================================================================
+// Count a warning of this call site with its value, e.g.
+//   TELEOP_WARN_AGGREGATED(logMecaAdapter, "value below min", val);
+#define TELEOP_WARN_AGGREGATED(category, site, value)                        \
+    do {                                                                     \
+        static teleop::WarningCounter& _warningCounter =                     \
+            teleop::WarningRegistry::getInstance().getCounter(               \
+                category, __FILE__, __LINE__, site);                         \
+        _warningCounter.add(value);                                          \
+    } while (0)
+
+
+#endif  // LOG_WARNING_H
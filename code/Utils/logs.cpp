@@ -1,56 +1,383 @@
 #include "logs.h"
 
+#include "cycle_monitor.h"
+#include "latency.h"
+#include "perf_counters.h"
+#include "queue_monitor.h"
+#include "sched_sampler.h"
 #include "settings.h"
 
 #include <QDateTime>
 #include <QDebug>
 #include <QDir>
-#include <QTextStream>
 #include <QThread>
 
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
 Q_LOGGING_CATEGORY(logLogger, "Logger")
 
+
+// ==========================================================================
+namespace {
+
+#if defined(__x86_64__) || defined(__i386__)
+// CPUID.80000007H:EDX[8]: constant rate in every P/C state
+bool hasInvariantTsc() {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) ||
+        eax < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+}
+
+
+quint64 readTsc() {
+    return __rdtsc();
+}
+#else
+bool hasInvariantTsc() {
+    return false;
+}
+
+
+quint64 readTsc() {
+    return 0;
+}
+#endif
+
+
+quint64 monotonicNanoseconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return quint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+
+// buffered mode: chunks allocated as the rows come, never moved
+const int TEXT_CHUNK_SIZE = 64 * 1024;  // [bytes]
+
+}  // namespace
+
 // ==========================================================================
 teleop::Logger::Logger(const QString& name, unsigned buffer_size,
                        QObject* parent)
-    : QObject(parent), _name(name), _bufferSize(buffer_size) {
+    : Logger(name, "", buffer_size, parent) {
+}
+
+
+teleop::Logger::Logger(const QString& name, const QString& units,
+                       unsigned buffer_size, QObject* parent)
+    : QObject(parent), _name(name), _units(units), _bufferSize(buffer_size),
+      _dropped(0), _spare(nullptr), _historyHead(0) {
     qDebug(logLogger()) << QThread::currentThreadId() << " | Logger::Logger"
                         << _name;
+    auto& settings = SettingsManager::getInstance();
+    _mode          = settings.getLogMode("nodes/log_mode");
+    _format        = settings.getLogFormat("nodes/log_format");
+    if (_format != LogFormat::text && _mode == LogMode::buffered) {
+        qWarning(logLogger()) << "Logger" << _name
+                              << convertLogFormatToQString(_format)
+                              << "format requires async mode: use text";
+        _format = LogFormat::text;
+    }
+    if (_format != LogFormat::binary &&
+        (_mode == LogMode::mapped || _mode == LogMode::session)) {
+        qInfo(logLogger()) << "Logger" << _name
+                           << convertLogModeToQString(_mode)
+                           << "mode is binary";
+        _format = LogFormat::binary;
+    }
+    // Keep a power of two history in memory only
+    if (_mode == LogMode::recorder) {
+        quint64 size = 1;
+        while (size < settings.getUnsigned("nodes/log_recorder_size")) {
+            size <<= 1;
+        }
+        _history     = new LogRecord[size];
+        _historyMask = size - 1;
+        FlightRecorder::getInstance().attach(this);
+        LogWriter::getInstance().attach(this);  // serves SIGUSR1
+        return;
+    }
+    // Register the channel in the shared session file
+    if (_mode == LogMode::session) {
+        _channel = LogSession::getInstance().registerChannel(_name, units);
+        _ring    = new SpscRing<LogRecord>(
+            settings.getUnsigned("nodes/log_ring_size"));
+        LogWriter::getInstance().attach(this);
+        return;
+    }
     // Create Logs Dir if not exist
-    QString dir_path =
-        SettingsManager::getInstance().getDirectoryPath() + "/logs/";
-    QDir dir;
+    QString dir_path = settings.getDirectoryPath() + "/logs/";
+    QDir    dir;
     if (!dir.exists(dir_path)) {
         dir.mkpath(dir_path);
     }
+    // Set the segments (each one is a standalone binary log)
+    if (_mode == LogMode::mapped) {
+        auto header = makeLogFileHeader(_name, units);
+        _header   = QByteArray(reinterpret_cast<const char*>(&header),
+                             sizeof(header));
+        _basePath = dir_path + "log_" + _name;
+        _segmentSize =
+            quint64(settings.getUnsigned("nodes/log_segment_size")) << 20;
+        _retired = new SpscRing<LogSegment*>(16);
+        _segment = _createSegment();
+        _spare   = _createSegment();
+        LogWriter::getInstance().attach(this);
+        return;
+    }
     // Set the logging file (create it if not exist)
-    _file = new QFile(dir_path + "log_" + _name + ".txt");
-    _file->open(QFile::WriteOnly);
+    switch (_format) {
+        case LogFormat::text: {
+            _file = new QFile(dir_path + "log_" + _name + ".txt");
+            _file->open(QFile::WriteOnly);
+            break;
+        }
+        case LogFormat::binary: {
+            _file = new QFile(dir_path + "log_" + _name + ".bin");
+            _file->open(QFile::WriteOnly);
+            auto header = makeLogFileHeader(_name, units);
+            _file->write(reinterpret_cast<const char*>(&header),
+                         sizeof(header));
+            break;
+        }
+        case LogFormat::compressed: {
+            _file = new QFile(dir_path + "log_" + _name + ".zlog");
+            _file->open(QFile::WriteOnly);
+            auto steps  = parseLogPrecision(
+                units, settings.getQString("nodes/log_precision"));
+            auto header = makeLogCompressedHeader(_name, units, steps.data());
+            _file->write(reinterpret_cast<const char*>(&header),
+                         sizeof(header));
+            _encoder = new LogEncoder(steps.data());
+            break;
+        }
+    }
     // Set the buffer
-    _buffer = new QString[_bufferSize];
+    switch (_mode) {
+        case LogMode::buffered: {
+            break;  // chunks allocated by write()
+        }
+        case LogMode::async: {
+            _ring = new SpscRing<LogRecord>(
+                settings.getUnsigned("nodes/log_ring_size"));
+            LogWriter::getInstance().attach(this);
+            break;
+        }
+        case LogMode::mapped:
+        case LogMode::session:
+        case LogMode::recorder: {
+            break;
+        }
+    }
 }
 
 
 teleop::Logger::~Logger() {
     qDebug(logLogger()) << QThread::currentThreadId() << " | Logger::~Logger"
                         << _name;
+    if (_mode == LogMode::recorder) {
+        FlightRecorder::getInstance().detach(this);
+    }
+    if (_mode != LogMode::buffered) {
+        // after detach this thread is the only consumer of the ring
+        LogWriter::getInstance().detach(this);
+    }
     flush();
-    _file->close();
-    delete[] _buffer;
+    if (_file) {
+        _file->close();
+    }
+    if (_mode == LogMode::session) {
+        LogSession::getInstance().unregisterChannel(_channel);
+    }
+    if (_mode == LogMode::mapped) {
+        LogSegment* full;
+        while (_retired->tryPop(full)) {
+            delete full;
+        }
+        delete _segment;
+        LogSegment* spare = _spare.exchange(nullptr);
+        if (spare) {
+            spare->remove();
+            delete spare;
+        }
+    }
+    if (_encoder && _encoder->getRowCount() > 0) {
+        const quint64 rows = _encoder->getRowCount();
+        const quint64 raw  = rows * (8 + 4 * LOG_FIELD_COUNT);
+        qInfo(logLogger()) << "Logger" << _name << "compressed" << rows
+                           << "records: ratio"
+                           << double(raw) / _encoder->getByteCount()
+                           << "encode" << _encodeNs / rows << "ns/record";
+    }
+    if (_dropped > 0) {
+        qWarning(logLogger()) << "Logger" << _name << "dropped"
+                              << static_cast<quint64>(_dropped)
+                              << "records: buffer full";
+    }
+    delete[] _history;
+    delete _ring;
+    delete _retired;
+    delete _encoder;
     delete _file;
 }
 
 
-void teleop::Logger::write(const QVector<float>& vec) {
-    // unsigned=32bit -> 2**32-1=4294967295 -> 1193h with sampling_rate=1000hz
-    auto timestamp = QString::number(LogClock::getInstance().getNanoseconds());
-    //    auto timestamp =
-    //    QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-    auto msg =
-        QString("%0|%1|%2|%3|%4|%5|%6\n")
-            .arg(timestamp, QString::number(vec[0]), QString::number(vec[1]),
-                 QString::number(vec[2]), QString::number(vec[3]),
-                 QString::number(vec[4]), QString::number(vec[5]));
+const QString& teleop::Logger::getName() const {
+    return _name;
+}
+
+
+const QString& teleop::Logger::getUnits() const {
+    return _units;
+}
+
+
+teleop::LogMode teleop::Logger::getMode() const {
+    return _mode;
+}
+
+
+quint64 teleop::Logger::getDropped() const {
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+
+unsigned teleop::Logger::drain() {
+    unsigned count = 0;
+    if (_mode == LogMode::recorder) {
+        return count;
+    }
+    if (_mode == LogMode::mapped) {
+        LogSegment* full;
+        while (_retired->tryPop(full)) {
+            delete full;  // truncate to the used size and unmap
+            count++;
+        }
+        if (!_spare.load(std::memory_order_acquire)) {
+            _spare.store(_createSegment(), std::memory_order_release);
+        }
+        return count;
+    }
+    LogRecord record;
+    if (_mode == LogMode::session) {
+        auto& session = LogSession::getInstance();
+        while (_ring->tryPop(record)) {
+            record.timestamp = _toTimestamp(record.timestamp);
+            session.collect(_channel, record);
+            count++;
+        }
+        return count;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    while (_ring->tryPop(record)) {
+        record.timestamp = _toTimestamp(record.timestamp);
+        switch (_format) {
+            case LogFormat::text: {
+                char row[LOG_TEXT_ROW_SIZE];
+                _output.append(row, formatLogTextRow(row, record.timestamp,
+                                                     record.values));
+                break;
+            }
+            case LogFormat::binary: {
+                char row[8 + 4 * LOG_FIELD_COUNT];
+                encodeLogRow(row, record.timestamp, record.values,
+                             LOG_FIELD_COUNT);
+                _output.append(row, sizeof(row));
+                break;
+            }
+            case LogFormat::compressed: {
+                char row[LOG_COMPRESSED_MAX_ROW];
+                _output.append(row, _encoder->encode(row, record.timestamp,
+                                                     record.values));
+                break;
+            }
+        }
+        count++;
+    }
+    if (_encoder) {
+        _encodeNs += timer.nsecsElapsed();
+    }
+    if (count > 0) {
+        _file->write(_output);
+        _output.clear();
+    }
+    return count;
+}
+
+
+void teleop::Logger::readHistory(QVector<LogRecord>& out) const {
+    const quint64 capacity = _historyMask + 1;
+    const quint64 last     = _historyHead.load(std::memory_order_acquire);
+    const quint64 first    = last > capacity ? last - capacity : 0;
+    QVector<LogRecord> copy(last - first);
+    for (quint64 i = first; i < last; ++i) {
+        copy[i - first] = _history[i & _historyMask];
+    }
+    // the producer may have overwritten the oldest slots meanwhile: the one
+    // being written now is the slot of record (head - capacity)
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const quint64 head  = _historyHead.load(std::memory_order_relaxed);
+    const quint64 valid = head >= capacity ? head - capacity + 1 : 0;
+    auto&   clock    = LogClock::getInstance();
+    quint64 previous = 0;
+    for (quint64 i = qMax(first, valid); i < last; ++i) {
+        LogRecord record = copy[i - first];
+        previous = qMax(previous, clock.toNanoseconds(record.timestamp));
+        record.timestamp = previous;
+        out.append(record);
+    }
+}
+
+
+static_assert(teleop::Vec6::size() == teleop::LOG_FIELD_COUNT,
+              "a channel row is one Vec6");
+
+
+void teleop::Logger::write(const Vec6& vec) {
+    if (_mode == LogMode::recorder) {
+        const quint64 head   = _historyHead.load(std::memory_order_relaxed);
+        LogRecord&    record = _history[head & _historyMask];
+        record.timestamp     = LogClock::getInstance().getTicks();
+        for (int i = 0; i < LOG_FIELD_COUNT; ++i) {
+            record.values[i] = vec[i];
+        }
+        _historyHead.store(head + 1, std::memory_order_release);
+        return;
+    }
+    if (_mode == LogMode::mapped) {
+        char row[8 + 4 * LOG_FIELD_COUNT];
+        encodeLogRow(row, LogClock::getInstance().getNanoseconds(), vec.values,
+                     LOG_FIELD_COUNT);
+        if (!_segment || !_segment->append(row, sizeof(row))) {
+            _rollSegment();
+            if (!_segment || !_segment->append(row, sizeof(row))) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return;
+    }
+    if (_mode == LogMode::async || _mode == LogMode::session) {
+        LogRecord record;
+        record.timestamp = LogClock::getInstance().getTicks();
+        for (int i = 0; i < 6; ++i) {
+            record.values[i] = vec[i];
+        }
+        if (!_ring->tryPush(record)) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
 
     if (_bufferIndex >= _bufferSize) {
         qDebug(logLogger())
@@ -60,18 +387,194 @@ void teleop::Logger::write(const QVector<float>& vec) {
         flush();
         exit(EXIT_FAILURE);
     } else {
-        _buffer[_bufferIndex] = msg;
+        if (_buffer.isEmpty() ||
+            _buffer.last().size() + LOG_TEXT_ROW_SIZE > TEXT_CHUNK_SIZE) {
+            _buffer.append(QByteArray());
+            _buffer.last().reserve(TEXT_CHUNK_SIZE);
+        }
+        char row[LOG_TEXT_ROW_SIZE];
+        const quint64 timestamp = LogClock::getInstance().getNanoseconds();
+        _buffer.last().append(row,
+                              formatLogTextRow(row, timestamp, vec.values));
         _bufferIndex++;
     }
 }
 
 
 void teleop::Logger::flush() {
-    QTextStream logStream(_file);
-    for (qint64 i = 0; i < _bufferSize; ++i) {
-        logStream << _buffer[i];
+    if (_mode == LogMode::mapped) {
+        return;  // already in the page cache
+    }
+    if (_mode == LogMode::recorder) {
+        return;  // written only by FlightRecorder::dump()
+    }
+    if (_mode == LogMode::async) {
+        LogWriter::getInstance().drain(this);
+        _file->flush();
+        return;
+    }
+    if (_mode == LogMode::session) {
+        LogWriter::getInstance().drain(this);
+        return;  // written by the LogWriter (or by the last channel)
+    }
+    for (const QByteArray& chunk : _buffer) {
+        _file->write(chunk);
+    }
+    _file->flush();
+}
+
+
+teleop::LogSegment* teleop::Logger::_createSegment() {
+    auto path = QString("%1_%2.bin")
+                    .arg(_basePath)
+                    .arg(_segmentIndex++, 3, 10, QChar('0'));
+    return LogSegment::create(path, _segmentSize, _header);
+}
+
+
+quint64 teleop::Logger::_toTimestamp(quint64 ticks) {
+    // a recalibration may move the conversion back by a few ns
+    _lastTimestamp = qMax(_lastTimestamp,
+                          LogClock::getInstance().toNanoseconds(ticks));
+    return _lastTimestamp;
+}
+
+
+void teleop::Logger::_rollSegment() {
+    LogSegment* next = _spare.exchange(nullptr, std::memory_order_acq_rel);
+    if (!next) {
+        return;  // the writer has not prepared it yet: drop
+    }
+    if (_segment && !_retired->tryPush(_segment)) {
+        delete _segment;  // writer far behind: close it here
+    }
+    _segment = next;
+}
+
+
+// ==========================================================================
+namespace {
+
+void disableLogWriter() {
+    teleop::LogWriter::getInstance().disable();
+}
+
+}  // namespace
+
+
+// ==========================================================================
+teleop::LogWriter& teleop::LogWriter::getInstance() {
+    static LogWriter instance;
+    return instance;
+}
+
+
+teleop::LogWriter::LogWriter() {
+    setObjectName("LogWriter");
+}
+
+
+void teleop::LogWriter::enable() {
+    _control.lock();
+    if (!_enabled) {
+        _enabled = true;
+        // exit() must not destroy the thread while it runs
+        static bool registered = false;
+        if (!registered) {
+            std::atexit(disableLogWriter);
+            registered = true;
+        }
+        if (!isRunning()) {
+            _start();
+        }
+    }
+    _control.unlock();
+}
+
+
+void teleop::LogWriter::disable() {
+    _control.lock();
+    _enabled = false;
+    _mutex.lock();
+    bool last = _loggers.isEmpty();
+    _mutex.unlock();
+    if (last && isRunning()) {
+        _stop();
+    }
+    _control.unlock();
+}
+
+
+void teleop::LogWriter::attach(Logger* logger) {
+    _control.lock();
+    _mutex.lock();
+    _loggers.append(logger);
+    _mutex.unlock();
+    if (!isRunning()) {
+        _start();
+    }
+    _control.unlock();
+}
+
+
+void teleop::LogWriter::detach(Logger* logger) {
+    _control.lock();
+    _mutex.lock();
+    _loggers.removeAll(logger);
+    bool last = _loggers.isEmpty();
+    _mutex.unlock();
+    if (last && !_enabled && isRunning()) {
+        _stop();
     }
-    logStream.flush();
+    _control.unlock();
+}
+
+
+void teleop::LogWriter::drain(Logger* logger) {
+    // the mutex keeps the ring single-consumer while the logger is attached
+    _mutex.lock();
+    logger->drain();
+    _mutex.unlock();
+}
+
+
+void teleop::LogWriter::run() {
+    qDebug(logLogger()) << QThread::currentThreadId() << " | LogWriter::run";
+    SchedSampler::getInstance().attach("LogWriter");
+    while (!isInterruptionRequested()) {
+        _drainAll();
+        msleep(_period);
+    }
+    _drainAll();
+}
+
+
+void teleop::LogWriter::_start() {
+    _period = SettingsManager::getInstance().getUnsigned(
+        "nodes/log_writer_period");
+    start(QThread::LowestPriority);
+}
+
+
+void teleop::LogWriter::_stop() {
+    requestInterruption();
+    wait();
+}
+
+
+void teleop::LogWriter::_drainAll() {
+    LogClock::getInstance().calibrate();
+    _mutex.lock();
+    for (auto logger : _loggers) {
+        logger->drain();
+    }
+    _mutex.unlock();
+    LogSession::getInstance().write();
+    FlightRecorder::getInstance().poll();
+    LatencyMonitor::getInstance().poll();
+    CycleRegistry::getInstance().poll();
+    QueueMonitor::getInstance().poll();
+    PerfMonitor::getInstance().poll();
 }
 
 
@@ -82,10 +585,37 @@ teleop::LogClock& teleop::LogClock::getInstance() {
 }
 
 
+teleop::LogClock::LogClock()
+    : _sequence(0), _baseTicks(0), _baseNs(0), _nsPerTick(1.0) {
+    _tsc = hasInvariantTsc();
+}
+
+
 void teleop::LogClock::start() {
-    if (!_timer.isValid()) {
-        _timer.start();
+    if (_timer.isValid()) {
+        return;
+    }
+    _timer.start();
+    if (!_tsc) {
+        qInfo(logLogger()) << "LogClock: invariant TSC not available, "
+                              "using QElapsedTimer";
+        return;
     }
+    // first estimate of the scale, refined by calibrate() during the run
+    _startNs    = monotonicNanoseconds();
+    _startTicks = readTsc();
+    QThread::msleep(10);
+    const quint64 ns    = monotonicNanoseconds();
+    const quint64 ticks = readTsc();
+    _baseTicks.store(ticks, std::memory_order_relaxed);
+    _baseNs.store(ns - _startNs, std::memory_order_relaxed);
+    _nsPerTick.store(double(ns - _startNs) / double(ticks - _startTicks),
+                     std::memory_order_relaxed);
+    _sequence.store(2, std::memory_order_release);
+    _lastCalibration = ns - _startNs;
+    qInfo(logLogger()) << "LogClock: TSC at"
+                       << 1e-6 / _nsPerTick.load(std::memory_order_relaxed)
+                       << "GHz";
 }
 
 
@@ -94,50 +624,261 @@ bool teleop::LogClock::isValid() {
 }
 
 
-quint64 teleop::LogClock::getNanoseconds() {
+bool teleop::LogClock::isTsc() const {
+    return _tsc;
+}
+
+
+quint64 teleop::LogClock::getTicks() {
+    if (_tsc) {
+        return readTsc();
+    }
     return _timer.nsecsElapsed();
 }
 
 
+quint64 teleop::LogClock::toNanoseconds(quint64 ticks) {
+    if (!_tsc) {
+        return ticks;
+    }
+    unsigned sequence;
+    quint64  base_ticks;
+    quint64  base_ns;
+    double   ns_per_tick;
+    do {
+        sequence    = _sequence.load(std::memory_order_acquire);
+        base_ticks  = _baseTicks.load(std::memory_order_relaxed);
+        base_ns     = _baseNs.load(std::memory_order_relaxed);
+        ns_per_tick = _nsPerTick.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((sequence & 1) ||
+             sequence != _sequence.load(std::memory_order_relaxed));
+    const qint64 delta = qint64(ticks - base_ticks) * ns_per_tick;
+    return (delta < 0 && quint64(-delta) > base_ns) ? 0 : base_ns + delta;
+}
+
+
+void teleop::LogClock::calibrate() {
+    if (!_tsc || !_timer.isValid()) {
+        return;
+    }
+    const quint64 ns = monotonicNanoseconds() - _startNs;
+    if (ns - _lastCalibration < 1000000000) {
+        return;
+    }
+    _lastCalibration = ns;
+    // slope over the whole run, offset continuous with the current one
+    const quint64 ticks       = readTsc();
+    const double  ns_per_tick = double(ns) / double(ticks - _startTicks);
+    const quint64 base_ns     = toNanoseconds(ticks);
+
+    const unsigned sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _baseTicks.store(ticks, std::memory_order_relaxed);
+    _baseNs.store(base_ns, std::memory_order_relaxed);
+    _nsPerTick.store(ns_per_tick, std::memory_order_relaxed);
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+
+
+quint64 teleop::LogClock::getNanoseconds() {
+    return toNanoseconds(getTicks());
+}
+
+
 float teleop::LogClock::getMilliseconds() {
-    return _timer.nsecsElapsed() * 1e-6;
+    return getNanoseconds() * 1e-6;
 }
 
 
 float teleop::LogClock::getSeconds() {
-    return _timer.nsecsElapsed() * 1e-9;
+    return getNanoseconds() * 1e-9;
 }
 
 
 // ==========================================================================
-void teleop::messageHandler(QtMsgType type, const QMessageLogContext& context,
-                            const QString& msg) {
-    char category[] = "               ";
-    int  dim        = std::min(strlen(category), strlen(context.category));
-    for (int i = 0; i < dim; ++i) {
-        category[i] = context.category[i];
-    }
-    switch (type) {
+namespace {
+
+void printMessage(const teleop::LogMessage& message) {
+    const char* label = "";
+    switch (message.type) {
         case QtInfoMsg:
-            fprintf(stderr, "[INFO    ][%s] %s\n", category,
-                    msg.toLocal8Bit().constData());
+            label = "INFO    ";
             break;
         case QtDebugMsg:
-            fprintf(stderr, "[DEBUG   ][%s] %s\n", category,
-                    msg.toLocal8Bit().constData());
+            label = "DEBUG   ";
             break;
         case QtWarningMsg:
-            fprintf(stderr, "[WARNING ][%s] %s\n", category,
-                    msg.toLocal8Bit().constData());
+            label = "WARNING ";
             break;
         case QtCriticalMsg:
-            fprintf(stderr, "[CRITICAL][%s] %s\n", category,
-                    msg.toLocal8Bit().constData());
+            label = "CRITICAL";
             break;
         case QtFatalMsg:
-            fprintf(stderr, "[FATAL   ][%s] %s\n", category,
-                    msg.toLocal8Bit().constData());
-            exit(EXIT_FAILURE);
+            label = "FATAL   ";
             break;
     }
+    fprintf(stderr, "[%s][%s] %s\n", label, message.category, message.text);
+}
+
+
+// UTF-8 without allocations (toLocal8Bit() would allocate)
+void encodeMessage(const QString& msg, char* dst, int size) {
+    int          length = 0;
+    const QChar* src    = msg.constData();
+    const int    count  = msg.size();
+    for (int i = 0; i < count; ++i) {
+        ushort c = src[i].unicode();
+        if (c < 0x80) {
+            if (length + 1 >= size) {
+                break;
+            }
+            dst[length++] = char(c);
+        } else if (c < 0x800) {
+            if (length + 2 >= size) {
+                break;
+            }
+            dst[length++] = char(0xC0 | (c >> 6));
+            dst[length++] = char(0x80 | (c & 0x3F));
+        } else if (src[i].isSurrogate()) {
+            if (length + 1 >= size) {
+                break;
+            }
+            dst[length++] = '?';
+        } else {
+            if (length + 3 >= size) {
+                break;
+            }
+            dst[length++] = char(0xE0 | (c >> 12));
+            dst[length++] = char(0x80 | ((c >> 6) & 0x3F));
+            dst[length++] = char(0x80 | (c & 0x3F));
+        }
+    }
+    dst[length] = '\0';
+}
+
+
+void disableMessageWriter() {
+    teleop::MessageWriter::getInstance().disable();
+}
+
+}  // namespace
+
+
+// ==========================================================================
+teleop::MessageWriter& teleop::MessageWriter::getInstance() {
+    static MessageWriter instance;
+    return instance;
+}
+
+
+teleop::MessageWriter::MessageWriter()
+    : _queue(1024), _enabled(false), _dropped(0), _droppedTotal(0) {
+    setObjectName("MessageWriter");
+}
+
+
+void teleop::MessageWriter::enable() {
+    if (_enabled.exchange(true)) {
+        return;
+    }
+    // exit() (also from qCritical + exit) must not lose the pending messages
+    static bool registered = false;
+    if (!registered) {
+        std::atexit(disableMessageWriter);
+        registered = true;
+    }
+    start(QThread::LowestPriority);
+}
+
+
+void teleop::MessageWriter::disable() {
+    if (!_enabled.exchange(false)) {
+        return;
+    }
+    requestInterruption();
+    wait();
+    flush();
+}
+
+
+bool teleop::MessageWriter::isEnabled() const {
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+
+bool teleop::MessageWriter::post(const LogMessage& message) {
+    if (!_queue.tryPush(message)) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        _droppedTotal.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+
+void teleop::MessageWriter::flush() {
+    _print();
+}
+
+
+quint64 teleop::MessageWriter::getDropped() const {
+    return _droppedTotal.load(std::memory_order_relaxed);
+}
+
+
+void teleop::MessageWriter::run() {
+    SchedSampler::getInstance().attach("MessageWriter");
+    while (!isInterruptionRequested()) {
+        if (_print() == 0) {
+            msleep(_period);
+        }
+    }
+}
+
+
+unsigned teleop::MessageWriter::_print() {
+    unsigned   count = 0;
+    LogMessage message;
+    while (_queue.tryPop(message)) {
+        printMessage(message);
+        count++;
+    }
+    quint64 dropped = _dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        fprintf(stderr, "[WARNING ][Logger         ] %llu messages dropped: "
+                        "queue full\n",
+                static_cast<unsigned long long>(dropped));
+    }
+    if (count > 0 || dropped > 0) {
+        fflush(stderr);
+    }
+    return count;
+}
+
+
+// ==========================================================================
+void teleop::messageHandler(QtMsgType type, const QMessageLogContext& context,
+                            const QString& msg) {
+    LogMessage message;
+    message.type    = type;
+    char category[] = "               ";
+    int  dim        = std::min(strlen(category), strlen(context.category));
+    for (int i = 0; i < dim; ++i) {
+        category[i] = context.category[i];
+    }
+    std::memcpy(message.category, category, sizeof(message.category));
+    encodeMessage(msg, message.text, sizeof(message.text));
+
+    auto& writer = MessageWriter::getInstance();
+    if (type == QtCriticalMsg || type == QtFatalMsg || !writer.isEnabled()) {
+        writer.flush();  // keep the order of the messages
+        printMessage(message);
+        if (type == QtFatalMsg) {
+            exit(EXIT_FAILURE);
+        }
+        return;
+    }
+    writer.post(message);
 }
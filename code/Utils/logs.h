@@ -1,59 +1,251 @@
 #ifndef LOGS_H
 #define LOGS_H
 
+#include "log_codec.h"
+#include "log_format.h"
+#include "log_recorder.h"
+#include "log_segment.h"
+#include "log_session.h"
+#include "ring_buffer.h"
+#include "settings.h"
+#include "vec.h"
+
 #include <QElapsedTimer>
 #include <QFile>
 #include <QLoggingCategory>
+#include <QMutex>
 #include <QObject>
+#include <QThread>
 #include <QVector3D>
 
+#include <atomic>
+
 Q_DECLARE_LOGGING_CATEGORY(logLogger)
 
 
 namespace teleop {
 
 // ==========================================================================
+// Monotonic clock of the logs, zero at start().
+// With an invariant TSC getTicks() is a bare rdtsc: the records keep the raw
+// ticks and the LogWriter converts them to nanoseconds. The scale is
+// measured against CLOCK_MONOTONIC at start() and refined by calibrate()
+// over the whole run; each update keeps the conversion continuous.
+// Without an invariant TSC the ticks are the nanoseconds of QElapsedTimer.
 class LogClock {  // singleton
   public:
     static LogClock& getInstance();
 
     void    start();
     bool    isValid();
+    bool    isTsc() const;
+    quint64 getTicks();                    // a few cycles
+    quint64 toNanoseconds(quint64 ticks);  // any thread
+    void    calibrate();                   // at most once per second
     quint64 getNanoseconds();
     float   getMilliseconds();
     float   getSeconds();
 
   private:
     QElapsedTimer _timer;
+    bool          _tsc             = false;
+    quint64       _startTicks      = 0;
+    quint64       _startNs         = 0;  // CLOCK_MONOTONIC at start()
+    quint64       _lastCalibration = 0;  // [ns] since start()
+    // conversion ns = baseNs + (ticks - baseTicks) * nsPerTick (seqlock)
+    std::atomic<unsigned> _sequence;
+    std::atomic<quint64>  _baseTicks;
+    std::atomic<quint64>  _baseNs;
+    std::atomic<double>   _nsPerTick;
 
-    LogClock()                = default;
+    LogClock();
     LogClock(const LogClock&) = delete;
     void operator=(const LogClock&) = delete;
 };
 
 // ==========================================================================
+// Units stored in the header of the binary logs
+const char* const LOG_UNITS_POSE   = "mm,mm,mm,deg,deg,deg";
+const char* const LOG_UNITS_TWIST  = "mm/s,mm/s,mm/s,deg/s,deg/s,deg/s";
+const char* const LOG_UNITS_WRENCH = "N,N,N,Nm,Nm,Nm";
+const char* const LOG_UNITS_SCHED  = "ms,ms,n,n,n,cpu";
+
+// ==========================================================================
+// Fixed-size sample pushed by the real-time threads in LogMode::async
+struct LogRecord {
+    quint64 timestamp = 0;  // LogClock ticks, [ns] once drained
+    float   values[6] = {};
+};
+
+// ==========================================================================
+// Modes (nodes/log_mode):
+// - buffered: records are formatted on the calling thread and kept in memory
+//             until destruction. Exit when nodes/log_size is exceeded.
+// - async:    records are pushed in a wait-free ring and formatted/written by
+//             the low priority LogWriter thread. When the ring is full the
+//             record is dropped and counted.
+// - mapped:   binary rows are copied by the calling thread straight into a
+//             pre-faulted mmap'd segment (log_<name>_<NNN>.bin), so every
+//             record written survives a crash. Segments roll over at
+//             nodes/log_segment_size MB: the LogWriter thread keeps the next
+//             one ready and closes the full ones.
+// - session:  like async, but the LogWriter thread merges the records of all
+//             the Loggers in a single log_session.bin (see LogSession).
+// - recorder: nothing is written: the last nodes/log_recorder_size records
+//             are kept in memory and dumped on a fault (see FlightRecorder).
+// Formats (nodes/log_format):
+// - text:   log_<name>.txt with "timestamp|v0|v1|v2|v3|v4|v5" lines
+// - binary: log_<name>.bin, see log_format.h (not with LogMode::buffered)
+// - compressed: log_<name>.zlog, quantized delta rows, see log_codec.h
+//               (async mode only)
 class Logger : public QObject {
     Q_OBJECT
 
   public:
     Logger(const QString& name, unsigned buffer_size,
            QObject* parent = nullptr);
+    Logger(const QString& name, const QString& units, unsigned buffer_size,
+           QObject* parent = nullptr);
     Logger(const Logger&) = delete;
     Logger(Logger&&)      = delete;
     ~Logger();
 
+    const QString& getName() const;
+    const QString& getUnits() const;
+    LogMode        getMode() const;
+    quint64        getDropped() const;
+
+    // async: consume the pending records of the ring
+    // session: move the pending records of the ring to the LogSession
+    // mapped: close the full segments and prepare the next one
+    // (LogWriter thread only)
+    unsigned drain();
+
+    // recorder: append the history, oldest first (any thread). Records
+    // overwritten by the producer during the copy are left out.
+    void readHistory(QVector<LogRecord>& out) const;
+
   private:
-    const QString  _name        = "Logger";
-    QFile*         _file        = nullptr;
-    QString*       _buffer      = nullptr;
-    const unsigned _bufferSize  = 1000;
-    unsigned       _bufferIndex = 0;
+    const QString       _name        = "Logger";
+    const QString       _units;
+    LogMode             _mode        = LogMode::buffered;
+    LogFormat           _format      = LogFormat::text;
+    QFile*              _file        = nullptr;
+    QVector<QByteArray> _buffer;              // text rows, in chunks
+    const unsigned      _bufferSize  = 1000;  // [rows]
+    unsigned            _bufferIndex = 0;
+    // async and session mode
+    SpscRing<LogRecord>* _ring          = nullptr;
+    quint32              _channel       = 0;
+    quint64              _lastTimestamp = 0;  // [ns] keeps them monotonic
+    std::atomic<quint64> _dropped;
+    QByteArray           _output;
+    LogEncoder*          _encoder       = nullptr;  // compressed format
+    quint64              _encodeNs      = 0;        // [ns] spent encoding
+    // mapped mode
+    QString                  _basePath;
+    QByteArray               _header;
+    quint64                  _segmentSize  = 0;
+    unsigned                 _segmentIndex = 0;
+    LogSegment*              _segment      = nullptr;  // producer only
+    std::atomic<LogSegment*> _spare;                   // writer -> producer
+    SpscRing<LogSegment*>*   _retired = nullptr;       // producer -> writer
+    // recorder mode
+    LogRecord*           _history     = nullptr;
+    quint64              _historyMask = 0;
+    std::atomic<quint64> _historyHead;  // records written (producer only)
+
+    LogSegment* _createSegment();
+    void        _rollSegment();
+    quint64     _toTimestamp(quint64 ticks);
 
   public slots:
-    void write(const QVector<float>& vec);
+    void write(const Vec6& vec);
     void flush();
 };
 
+// ==========================================================================
+// Low priority thread that periodically drains every attached async Logger,
+// writes the merged LogSession, serves the FlightRecorder dump requests,
+// calibrates the LogClock and polls the periodic reports (latency, cycle,
+// queue, perf). It runs while enabled (for the whole run, from main) or
+// while at least one Logger is attached.
+class LogWriter : public QThread {  // singleton
+    Q_OBJECT
+
+  public:
+    static LogWriter& getInstance();
+
+    void enable();   // run without loggers too (stopped at exit)
+    void disable();  // stop once no Logger is attached
+    void attach(Logger* logger);
+    void detach(Logger* logger);
+    void drain(Logger* logger);  // drain now from the calling thread
+
+  protected:
+    void run() override;
+
+  private:
+    QMutex           _control;  // serializes the starts and stops
+    QMutex           _mutex;    // never taken by the producers
+    QVector<Logger*> _loggers;
+    bool             _enabled = false;
+    unsigned         _period  = 50;  // [ms]
+
+    LogWriter();
+    LogWriter(const LogWriter&) = delete;
+    void operator=(const LogWriter&) = delete;
+
+    void _start();
+    void _stop();
+    void _drainAll();
+};
+
+// ==========================================================================
+// Message formatted by messageHandler: fixed size, so posting it to the
+// MessageWriter never allocates. Longer messages are truncated.
+struct LogMessage {
+    QtMsgType type;
+    char      category[16];
+    char      text[236];
+};
+
+// ==========================================================================
+// Low priority thread that prints the qDebug/qInfo/qWarning messages posted
+// by messageHandler to stderr. The queue is lock-free: a thread that logs
+// only copies the message, and when the queue is full the message is
+// dropped and counted instead of blocking. qCritical/qFatal messages (often
+// followed by exit()) are printed synchronously, after the pending ones.
+class MessageWriter : public QThread {  // singleton
+    Q_OBJECT
+
+  public:
+    static MessageWriter& getInstance();
+
+    void    enable();   // start the thread (stopped at exit)
+    void    disable();  // stop the thread and print the pending messages
+    bool    isEnabled() const;
+    bool    post(const LogMessage& message);  // false if dropped
+    void    flush();  // print the pending messages from the calling thread
+    quint64 getDropped() const;
+
+  protected:
+    void run() override;
+
+  private:
+    MpmcRing<LogMessage> _queue;
+    std::atomic<bool>    _enabled;
+    std::atomic<quint64> _dropped;  // not yet reported
+    std::atomic<quint64> _droppedTotal;
+    unsigned             _period = 10;  // [ms]
+
+    MessageWriter();
+    MessageWriter(const MessageWriter&) = delete;
+    void operator=(const MessageWriter&) = delete;
+
+    unsigned _print();
+};
+
 // ==========================================================================
 void messageHandler(QtMsgType type, const QMessageLogContext& context,
                     const QString& msg);
@@ -0,0 +1,186 @@
+#include "metrics.h"
+#include "logs.h"
+
+#include <QDebug>
+
+
+// ==========================================================================
+namespace {
+
+const char* const TYPE_NAMES[] = {"counter", "gauge", "summary"};
+
+// quantiles of the summaries
+const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+
+QByteArray formatSeries(const QString& name, const QString& labels,
+                        const QByteArray& value) {
+    QByteArray row = name.toUtf8();
+    if (!labels.isEmpty()) {
+        row += '{' + labels.toUtf8() + '}';
+    }
+    return row + ' ' + value + '\n';
+}
+
+
+QString joinLabels(const QString& labels, const QString& label) {
+    return labels.isEmpty() ? label : labels + ',' + label;
+}
+
+}  // namespace
+
+
+// ==========================================================================
+teleop::MetricCounter::MetricCounter() : _value(0) {
+}
+
+
+void teleop::MetricCounter::increment(quint64 n) {
+    _value.fetch_add(n, std::memory_order_relaxed);
+}
+
+
+quint64 teleop::MetricCounter::getValue() const {
+    return _value.load(std::memory_order_relaxed);
+}
+
+
+// ==========================================================================
+teleop::MetricGauge::MetricGauge() : _value(0) {
+}
+
+
+void teleop::MetricGauge::set(double value) {
+    _value.store(value, std::memory_order_relaxed);
+}
+
+
+double teleop::MetricGauge::getValue() const {
+    return _value.load(std::memory_order_relaxed);
+}
+
+
+// ==========================================================================
+teleop::MetricsRegistry& teleop::MetricsRegistry::getInstance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+
+teleop::MetricsRegistry::~MetricsRegistry() {
+    for (auto& family : _families) {
+        for (auto& series : family.series) {
+            delete series.counter;
+            delete series.gauge;
+            delete series.histogram;
+        }
+    }
+}
+
+
+teleop::MetricCounter& teleop::MetricsRegistry::getCounter(
+    const QString& name, const QString& help, const QString& labels) {
+    return *_getSeries(name, help, labels, MetricType::counter).counter;
+}
+
+
+teleop::MetricGauge& teleop::MetricsRegistry::getGauge(const QString& name,
+                                                       const QString& help,
+                                                       const QString& labels) {
+    return *_getSeries(name, help, labels, MetricType::gauge).gauge;
+}
+
+
+teleop::LatencyHistogram& teleop::MetricsRegistry::getHistogram(
+    const QString& name, const QString& help, const QString& labels) {
+    return *_getSeries(name, help, labels, MetricType::summary).histogram;
+}
+
+
+QByteArray teleop::MetricsRegistry::expose() {
+    QByteArray text;
+    _mutex.lock();
+    for (auto it = _families.cbegin(); it != _families.cend(); ++it) {
+        const QString& name   = it.key();
+        const Family&  family = it.value();
+        text += "# HELP " + name.toUtf8() + ' ' + family.help.toUtf8() + '\n';
+        text += "# TYPE " + name.toUtf8() + ' ' +
+                TYPE_NAMES[int(family.type)] + '\n';
+        for (const auto& series : family.series) {
+            switch (family.type) {
+                case MetricType::counter:
+                    text += formatSeries(
+                        name, series.labels,
+                        QByteArray::number(series.counter->getValue()));
+                    break;
+                case MetricType::gauge:
+                    text += formatSeries(
+                        name, series.labels,
+                        QByteArray::number(series.gauge->getValue(), 'g', 10));
+                    break;
+                case MetricType::summary: {
+                    const LatencyHistogram* histogram = series.histogram;
+                    for (double quantile : QUANTILES) {
+                        const QString label =
+                            QString("quantile=\"%1\"").arg(quantile);
+                        const double value =
+                            histogram->getPercentile(quantile * 100) * 1e-9;
+                        text += formatSeries(
+                            name, joinLabels(series.labels, label),
+                            QByteArray::number(value, 'g', 6));
+                    }
+                    text += formatSeries(
+                        name + "_sum", series.labels,
+                        QByteArray::number(histogram->getSum() * 1e-9, 'g',
+                                           10));
+                    text += formatSeries(
+                        name + "_count", series.labels,
+                        QByteArray::number(histogram->getCount()));
+                    break;
+                }
+            }
+        }
+    }
+    _mutex.unlock();
+    return text;
+}
+
+
+teleop::MetricsRegistry::Series teleop::MetricsRegistry::_getSeries(
+    const QString& name, const QString& help, const QString& labels,
+    MetricType type) {
+    QMutexLocker locker(&_mutex);
+    auto         it = _families.find(name);
+    if (it == _families.end()) {
+        Family family;
+        family.help = help;
+        family.type = type;
+        it          = _families.insert(name, family);
+    } else if (it->type != type) {
+        qCritical(logLogger()) << "MetricsRegistry:" << name
+                               << "already registered as"
+                               << TYPE_NAMES[int(it->type)];
+        exit(EXIT_FAILURE);
+    }
+    for (auto& series : it->series) {
+        if (series.labels == labels) {
+            return series;
+        }
+    }
+    Series series;
+    series.labels = labels;
+    switch (type) {
+        case MetricType::counter:
+            series.counter = new MetricCounter();
+            break;
+        case MetricType::gauge:
+            series.gauge = new MetricGauge();
+            break;
+        case MetricType::summary:
+            series.histogram = new LatencyHistogram(
+                labels.isEmpty() ? name : name + '{' + labels + '}');
+            break;
+    }
+    it->series.append(series);
+    return it->series.last();
+}
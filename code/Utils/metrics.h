@@ -0,0 +1,100 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "latency.h"
+
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+
+namespace teleop {
+
+// ==========================================================================
+// Monotonic counter (Prometheus "counter")
+class MetricCounter {
+  public:
+    MetricCounter();
+    MetricCounter(const MetricCounter&) = delete;
+    MetricCounter(MetricCounter&&)      = delete;
+
+    void    increment(quint64 n = 1);
+    quint64 getValue() const;
+
+  private:
+    std::atomic<quint64> _value;
+};
+
+// ==========================================================================
+// Last value set (Prometheus "gauge")
+class MetricGauge {
+  public:
+    MetricGauge();
+    MetricGauge(const MetricGauge&) = delete;
+    MetricGauge(MetricGauge&&)      = delete;
+
+    void   set(double value);
+    double getValue() const;
+
+  private:
+    std::atomic<double> _value;
+};
+
+// ==========================================================================
+enum class MetricType { counter, gauge, summary };
+
+// ==========================================================================
+// Metrics of the pipeline, exported in the Prometheus text format (0.0.4)
+// by the MetricsServer. A metric is identified by its name and its labels
+// (e.g. "loop=\"TouchNode\""): the getters create it on the first call and
+// return the same one afterwards. Metrics live until exit, so the owners
+// keep a reference (taken outside the control loops, the registration
+// locks) and update it with relaxed atomics only: the control threads never
+// block on the exporter.
+// Histograms are LatencyHistograms in [ns], exported as summaries in [s].
+class MetricsRegistry {  // singleton
+  public:
+    static MetricsRegistry& getInstance();
+
+    MetricCounter&    getCounter(const QString& name, const QString& help,
+                                 const QString& labels = QString());
+    MetricGauge&      getGauge(const QString& name, const QString& help,
+                               const QString& labels = QString());
+    LatencyHistogram& getHistogram(const QString& name, const QString& help,
+                                   const QString& labels = QString());
+
+    QByteArray expose();  // exporter thread
+
+  private:
+    struct Series {
+        QString           labels;
+        MetricCounter*    counter   = nullptr;
+        MetricGauge*      gauge     = nullptr;
+        LatencyHistogram* histogram = nullptr;
+    };
+    struct Family {
+        QString         help;
+        MetricType      type;
+        QVector<Series> series;
+    };
+
+    QMutex                _mutex;
+    QMap<QString, Family> _families;  // sorted by name
+
+    MetricsRegistry() = default;
+    ~MetricsRegistry();
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    void operator=(const MetricsRegistry&) = delete;
+
+    Series _getSeries(const QString& name, const QString& help,
+                      const QString& labels, MetricType type);
+};
+
+}  // namespace teleop
+
+
+#endif  // METRICS_H
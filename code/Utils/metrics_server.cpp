@@ -0,0 +1,86 @@
+#include "metrics_server.h"
+#include "logs.h"
+#include "metrics.h"
+#include "settings.h"
+
+#include <QDebug>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+
+// ==========================================================================
+teleop::MetricsServer& teleop::MetricsServer::getInstance() {
+    static MetricsServer instance;
+    return instance;
+}
+
+
+teleop::MetricsServer::MetricsServer() {
+    _port = quint16(
+        SettingsManager::getInstance().getUnsigned("nodes/metrics_port"));
+}
+
+
+void teleop::MetricsServer::enable() {
+    if (_port != 0 && !isRunning()) {
+        start(QThread::LowPriority);
+    }
+}
+
+
+void teleop::MetricsServer::disable() {
+    requestInterruption();
+    wait();
+}
+
+
+void teleop::MetricsServer::run() {
+    QTcpServer server;
+    if (!server.listen(QHostAddress::LocalHost, _port)) {
+        qWarning(logLogger()) << "MetricsServer: cannot listen on port"
+                              << _port << ":" << server.errorString();
+        return;
+    }
+    qInfo(logLogger()).nospace()
+        << "MetricsServer: http://127.0.0.1:" << _port << "/metrics";
+    while (!isInterruptionRequested()) {
+        if (!server.waitForNewConnection(_period)) {
+            continue;
+        }
+        while (QTcpSocket* socket = server.nextPendingConnection()) {
+            _serve(socket);
+            delete socket;
+        }
+    }
+}
+
+
+void teleop::MetricsServer::_serve(QTcpSocket* socket) {
+    // only the request line matters, the headers are ignored
+    while (!socket->canReadLine()) {
+        if (!socket->waitForReadyRead(_timeout)) {
+            return;
+        }
+    }
+    const auto request = socket->readLine().trimmed().split(' ');
+    QByteArray status  = "200 OK";
+    QByteArray body;
+    if (request.size() < 2 || request[0] != "GET") {
+        status = "405 Method Not Allowed";
+    } else if (request[1] == "/metrics" || request[1] == "/") {
+        body = MetricsRegistry::getInstance().expose();
+    } else {
+        status = "404 Not Found";
+    }
+    socket->write("HTTP/1.0 " + status +
+                  "\r\n"
+                  "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                  "Content-Length: " +
+                  QByteArray::number(body.size()) +
+                  "\r\n"
+                  "Connection: close\r\n"
+                  "\r\n" +
+                  body);
+    socket->disconnectFromHost();  // once written
+    socket->waitForDisconnected(_timeout);
+}
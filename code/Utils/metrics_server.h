@@ -0,0 +1,43 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <QThread>
+
+class QTcpSocket;
+
+
+namespace teleop {
+
+// ==========================================================================
+// Low priority thread serving the MetricsRegistry in the Prometheus text
+// format: GET /metrics on 127.0.0.1:nodes/metrics_port (0: disabled). The
+// requests are served one at a time with blocking sockets and a timeout, a
+// slow scraper only delays the next scrape.
+class MetricsServer : public QThread {  // singleton
+    Q_OBJECT
+
+  public:
+    static MetricsServer& getInstance();
+
+    void enable();   // start the thread if a port is set
+    void disable();  // stop the thread
+
+  protected:
+    void run() override;
+
+  private:
+    quint16  _port    = 0;
+    unsigned _period  = 100;   // [ms] between two checks of disable()
+    int      _timeout = 1000;  // [ms] of a request
+
+    MetricsServer();
+    MetricsServer(const MetricsServer&) = delete;
+    void operator=(const MetricsServer&) = delete;
+
+    void _serve(QTcpSocket* socket);
+};
+
+}  // namespace teleop
+
+
+#endif  // METRICS_SERVER_H
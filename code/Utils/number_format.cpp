@@ -0,0 +1,197 @@
+#include "number_format.h"
+
+#include <cmath>
+#include <cstring>
+
+
+// ==========================================================================
+namespace {
+
+const quint64 POW10[] = {1ULL,
+                         10ULL,
+                         100ULL,
+                         1000ULL,
+                         10000ULL,
+                         100000ULL,
+                         1000000ULL,
+                         10000000ULL,
+                         100000000ULL,
+                         1000000000ULL,
+                         10000000000ULL,
+                         100000000000ULL,
+                         1000000000000ULL,
+                         10000000000000ULL,
+                         100000000000000ULL,
+                         1000000000000000ULL,
+                         10000000000000000ULL,
+                         100000000000000000ULL,
+                         1000000000000000000ULL};
+
+
+// 10^exp as a double, exact up to 10^22
+double powerOf10(int exp) {
+    if (exp >= 0 && exp <= 18) {
+        return double(POW10[exp]);
+    }
+    return std::pow(10.0, exp);
+}
+
+
+// digits of value, left padded with zeros to width
+int putDigits(char* dst, quint64 value, int width = 1) {
+    char tmp[20];
+    int  size = 0;
+    do {
+        tmp[size++] = char('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (size < width) {
+        tmp[size++] = '0';
+    }
+    for (int i = 0; i < size; ++i) {
+        dst[i] = tmp[size - 1 - i];
+    }
+    return size;
+}
+
+
+int putSpecial(char* dst, float value) {
+    if (std::isnan(value)) {
+        std::memcpy(dst, "nan", 3);
+        return 3;
+    }
+    if (value < 0) {
+        std::memcpy(dst, "-inf", 4);
+        return 4;
+    }
+    std::memcpy(dst, "inf", 3);
+    return 3;
+}
+
+}  // namespace
+
+
+// ==========================================================================
+int teleop::formatUnsigned(char* dst, quint64 value) {
+    return putDigits(dst, value);
+}
+
+
+int teleop::formatInteger(char* dst, qint64 value) {
+    if (value < 0) {
+        dst[0] = '-';
+        return 1 + putDigits(dst + 1, 0 - quint64(value));
+    }
+    return putDigits(dst, quint64(value));
+}
+
+
+int teleop::formatFloat(char* dst, float value) {
+    if (!std::isfinite(value)) {
+        return putSpecial(dst, value);
+    }
+    if (value == 0) {
+        dst[0] = '0';
+        return 1;
+    }
+    int size = 0;
+    if (value < 0) {
+        dst[size++] = '-';
+    }
+    // Find the shortest mantissa m of p digits with float(m * 10^(exp-p+1))
+    // == value (9 digits always round-trip a float)
+    const double abs   = std::fabs(double(value));
+    int          exp   = int(std::floor(std::log10(abs)));
+    if (exp >= 0 ? abs < powerOf10(exp) : abs * powerOf10(-exp) < 1) {
+        exp--;  // log10 rounded up
+    }
+    const int base   = exp;
+    quint64   digits = 0;
+    int       count  = 1;
+    for (; count <= 9; ++count) {
+        exp       = base;
+        int shift = count - 1 - exp;
+        digits    = quint64(std::llround(
+            shift >= 0 ? abs * powerOf10(shift) : abs / powerOf10(-shift)));
+        if (digits >= POW10[count]) {  // rounded up to the next power of ten
+            digits /= 10;
+            exp++;
+            shift--;
+        }
+        const double back =
+            shift >= 0 ? digits / powerOf10(shift) : digits * powerOf10(-shift);
+        if (float(back) == float(abs)) {
+            break;
+        }
+    }
+    count = qMin(count, 9);
+    while (count > 1 && digits % 10 == 0) {
+        digits /= 10;
+        count--;
+    }
+    char mantissa[9];
+    putDigits(mantissa, digits, count);
+
+    if (exp < -5 || exp >= 9) {
+        // d[.ddd]e(+|-)XX
+        dst[size++] = mantissa[0];
+        if (count > 1) {
+            dst[size++] = '.';
+            std::memcpy(dst + size, mantissa + 1, count - 1);
+            size += count - 1;
+        }
+        dst[size++] = 'e';
+        dst[size++] = exp < 0 ? '-' : '+';
+        return size + putDigits(dst + size, quint64(exp < 0 ? -exp : exp), 2);
+    }
+    if (exp < 0) {
+        // 0.000ddd
+        dst[size++] = '0';
+        dst[size++] = '.';
+        for (int i = -1; i > exp; --i) {
+            dst[size++] = '0';
+        }
+        std::memcpy(dst + size, mantissa, count);
+        return size + count;
+    }
+    // ddd[.ddd] (zero padded when the digits end before the point)
+    for (int i = 0; i <= exp; ++i) {
+        dst[size++] = i < count ? mantissa[i] : '0';
+    }
+    if (count > exp + 1) {
+        dst[size++] = '.';
+        std::memcpy(dst + size, mantissa + exp + 1, count - exp - 1);
+        size += count - exp - 1;
+    }
+    return size;
+}
+
+
+int teleop::formatFixed(char* dst, double value, int decimals) {
+    decimals = qBound(0, decimals, 9);
+    if (!std::isfinite(value) ||
+        std::fabs(value) >= 1e18 / powerOf10(decimals)) {
+        return formatFloat(dst, float(value));
+    }
+    const quint64 scaled =
+        quint64(std::llround(std::fabs(value) * powerOf10(decimals)));
+    if (scaled == 0) {
+        dst[0] = '0';  // no "-0"
+        return 1;
+    }
+    int size = 0;
+    if (value < 0) {
+        dst[size++] = '-';
+    }
+    size += putDigits(dst + size, scaled / POW10[decimals]);
+    quint64 fraction = scaled % POW10[decimals];
+    if (fraction == 0) {
+        return size;
+    }
+    while (fraction % 10 == 0) {
+        fraction /= 10;
+        decimals--;
+    }
+    dst[size++] = '.';
+    return size + putDigits(dst + size, fraction, decimals);
+}
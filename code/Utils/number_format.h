@@ -0,0 +1,32 @@
+#ifndef NUMBER_FORMAT_H
+#define NUMBER_FORMAT_H
+
+#include <QtGlobal>
+
+
+namespace teleop {
+
+// ==========================================================================
+// Number to text without heap allocation, locale or stream: every function
+// writes into dst (no terminating '\0') and returns the number of chars.
+// dst must hold at least NUMBER_FORMAT_SIZE chars.
+const int NUMBER_FORMAT_SIZE = 24;
+
+int formatUnsigned(char* dst, quint64 value);
+int formatInteger(char* dst, qint64 value);
+
+// Shortest decimal that reads back as the same float (at most 9 significant
+// digits). Like QString::number(value, 'g'), exponent notation is used below
+// 1e-5 and from 1e9, e.g. "0.1", "-12.5", "1e-06", "3.4028235e+38".
+int formatFloat(char* dst, float value);
+
+// value rounded to at most decimals (0-9) digits after the point, trailing
+// zeros removed: formatFixed(dst, 12.5f, 3) = "12.5". Never uses the exponent
+// notation (parsers like the robot one do not accept it), so |value| must be
+// below 1e18 / 10^decimals: bigger values fall back to formatFloat.
+int formatFixed(char* dst, double value, int decimals);
+
+}  // namespace teleop
+
+
+#endif  // NUMBER_FORMAT_H
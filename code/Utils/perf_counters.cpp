@@ -0,0 +1,286 @@
+#include "perf_counters.h"
+#include "logs.h"
+#include "settings.h"
+
+#include <QDebug>
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+// ==========================================================================
+namespace {
+
+const char* const COUNTER_NAMES[] = {"cycles",       "instructions",
+                                     "cache_misses", "branch_misses",
+                                     "ctx_switches", "migrations"};
+
+}  // namespace
+
+
+// ==========================================================================
+teleop::PerfGroup::PerfGroup() {
+    for (int i = 0; i < int(PerfCounter::count); ++i) {
+        _fds[i]   = -1;
+        _slots[i] = -1;
+    }
+    for (int i = 0; i < int(PerfCounter::count); ++i) {
+        int fd = _open(PerfCounter(i));
+        if (fd < 0 && (errno == EACCES || errno == EPERM) && !_excludeKernel) {
+            _excludeKernel = true;  // user space only is still permitted
+            fd             = _open(PerfCounter(i));
+        }
+        if (fd < 0) {
+            _error = errno;
+            continue;
+        }
+        _fds[i]   = fd;
+        _slots[i] = _opened++;
+        if (_leader < 0) {
+            _leader = fd;
+        }
+    }
+#ifdef __linux__
+    if (_leader >= 0) {
+        ioctl(_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+
+teleop::PerfGroup::~PerfGroup() {
+#ifdef __linux__
+    for (int fd : _fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+
+bool teleop::PerfGroup::isValid() const {
+    return _leader >= 0;
+}
+
+
+bool teleop::PerfGroup::isOpen(PerfCounter counter) const {
+    return _fds[int(counter)] >= 0;
+}
+
+
+int teleop::PerfGroup::getError() const {
+    return _error;
+}
+
+
+bool teleop::PerfGroup::read(quint64* values) {
+#ifdef __linux__
+    // PERF_FORMAT_GROUP: { nr, value[nr] } in the opening order
+    if (_leader < 0) {
+        return false;
+    }
+    quint64       buffer[1 + int(PerfCounter::count)];
+    const ssize_t size = ::read(_leader, buffer, sizeof(buffer));
+    if (size < ssize_t(sizeof(quint64) * (1 + _opened))) {
+        return false;
+    }
+    for (int i = 0; i < int(PerfCounter::count); ++i) {
+        values[i] = _slots[i] >= 0 ? buffer[1 + _slots[i]] : 0;
+    }
+    return true;
+#else
+    Q_UNUSED(values);
+    return false;
+#endif
+}
+
+
+int teleop::PerfGroup::_open(PerfCounter counter) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    switch (counter) {
+        case PerfCounter::cycles:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfCounter::instructions:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfCounter::cacheMisses:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PerfCounter::branchMisses:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PerfCounter::contextSwitches:
+            attr.type   = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+            break;
+        case PerfCounter::migrations:
+            attr.type   = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_CPU_MIGRATIONS;
+            break;
+        case PerfCounter::count:
+            return -1;
+    }
+    attr.read_format    = PERF_FORMAT_GROUP;
+    attr.disabled       = _leader < 0;  // the leader starts the whole group
+    attr.exclude_kernel = _excludeKernel;
+    attr.exclude_hv     = 1;
+    // calling thread, any cpu
+    return int(syscall(__NR_perf_event_open, &attr, 0, -1, _leader, 0));
+#else
+    Q_UNUSED(counter);
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+
+// ==========================================================================
+bool teleop::PerfMonitor::_enabled = false;
+
+
+teleop::PerfMonitor& teleop::PerfMonitor::getInstance() {
+    static PerfMonitor instance;
+    return instance;
+}
+
+
+teleop::PerfMonitor::PerfMonitor() {
+    auto& settings = SettingsManager::getInstance();
+    _enabled       = settings.getBool("nodes/enable_perf_counters");
+    _period        = settings.getUnsigned("nodes/perf_report_period");
+    _stages[int(PerfStage::touchCycle)].name        = "touch_cycle";
+    _stages[int(PerfStage::supervisorRequest)].name = "supervisor_request";
+    _stages[int(PerfStage::mecaCycle)].name         = "meca_cycle";
+    for (auto& stage : _stages) {
+        stage.count.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < int(PerfCounter::count); ++i) {
+            stage.totals[i].store(0, std::memory_order_relaxed);
+            stage.histograms[i] = new LatencyHistogram(
+                QString("%1 %2").arg(stage.name, COUNTER_NAMES[i]));
+        }
+    }
+    _timer.start();
+}
+
+
+teleop::PerfMonitor::~PerfMonitor() {
+    for (auto& stage : _stages) {
+        for (auto histogram : stage.histograms) {
+            delete histogram;
+        }
+    }
+}
+
+
+bool teleop::PerfMonitor::isEnabled() {
+    getInstance();  // read the settings once
+    return _enabled;
+}
+
+
+teleop::PerfGroup* teleop::PerfMonitor::getGroup() {
+    // opened by the first scope of the thread, closed at thread exit
+    static thread_local PerfGroup group;
+    static thread_local bool      warned = false;
+    if (!group.isValid() && !warned) {
+        warned = true;
+        qWarning(logLogger())
+            << "PerfMonitor: perf events not available in this thread ("
+            << std::strerror(group.getError())
+            << "), see /proc/sys/kernel/perf_event_paranoid";
+    }
+    return group.isValid() ? &group : nullptr;
+}
+
+
+void teleop::PerfMonitor::record(PerfStage stage, const quint64* deltas) {
+    Stage& target = _stages[int(stage)];
+    target.count.fetch_add(1, std::memory_order_relaxed);
+    for (int i = 0; i < int(PerfCounter::count); ++i) {
+        target.totals[i].fetch_add(deltas[i], std::memory_order_relaxed);
+        target.histograms[i]->record(deltas[i]);
+    }
+}
+
+
+QString teleop::PerfMonitor::getSummary(PerfStage stage) const {
+    const Stage&  source = _stages[int(stage)];
+    const quint64 cycles =
+        source.totals[int(PerfCounter::cycles)].load(std::memory_order_relaxed);
+    const quint64 instructions =
+        source.totals[int(PerfCounter::instructions)].load(
+            std::memory_order_relaxed);
+    QString summary = QString("perf %1: n=%2 ipc=%3")
+                          .arg(source.name)
+                          .arg(source.count.load(std::memory_order_relaxed))
+                          .arg(cycles > 0 ? double(instructions) / cycles : 0,
+                               0, 'f', 2);
+    for (int i = 0; i < int(PerfCounter::count); ++i) {
+        const LatencyHistogram* histogram = source.histograms[i];
+        summary += QString(" | %1 p50=%2 p99=%3 max=%4")
+                       .arg(COUNTER_NAMES[i])
+                       .arg(histogram->getPercentile(50))
+                       .arg(histogram->getPercentile(99))
+                       .arg(histogram->getMax());
+    }
+    return summary;
+}
+
+
+void teleop::PerfMonitor::poll() {
+    if (_period == 0 || _timer.elapsed() < _period) {
+        return;
+    }
+    _timer.restart();
+    report();
+}
+
+
+void teleop::PerfMonitor::report() {
+    for (int i = 0; i < int(PerfStage::count); ++i) {
+        if (_stages[i].count.load(std::memory_order_relaxed) > 0) {
+            qInfo(logLogger()).noquote() << getSummary(PerfStage(i));
+        }
+    }
+}
+
+
+// ==========================================================================
+teleop::PerfScope::PerfScope(PerfStage stage) : _stage(stage) {
+    if (!PerfMonitor::isEnabled()) {
+        return;
+    }
+    _group = PerfMonitor::getInstance().getGroup();
+    if (_group && !_group->read(_start)) {
+        _group = nullptr;
+    }
+}
+
+
+teleop::PerfScope::~PerfScope() {
+    quint64 end[int(PerfCounter::count)];
+    if (!_group || !_group->read(end)) {
+        return;
+    }
+    for (int i = 0; i < int(PerfCounter::count); ++i) {
+        end[i] -= _start[i];
+    }
+    PerfMonitor::getInstance().record(_stage, end);
+}
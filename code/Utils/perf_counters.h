@@ -0,0 +1,117 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include "latency.h"
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <atomic>
+
+
+namespace teleop {
+
+// ==========================================================================
+enum class PerfCounter {
+    cycles,
+    instructions,
+    cacheMisses,
+    branchMisses,
+    contextSwitches,
+    migrations,
+    count
+};
+
+// ==========================================================================
+// Hardware and software counters of the calling thread, opened with
+// perf_event_open as a single group (one read() for all of them). The
+// counters the kernel refuses (perf_event_paranoid, no PMU in a VM, ...)
+// are left out: with none at all the group is invalid and reads nothing.
+class PerfGroup {
+  public:
+    PerfGroup();
+    PerfGroup(const PerfGroup&) = delete;
+    PerfGroup(PerfGroup&&)      = delete;
+    ~PerfGroup();
+
+    bool isValid() const;
+    bool isOpen(PerfCounter counter) const;
+    int  getError() const;       // errno of the last counter refused
+    bool read(quint64* values);  // PerfCounter::count values, false on error
+
+  private:
+    int  _leader = -1;
+    int  _fds[int(PerfCounter::count)];
+    int  _slots[int(PerfCounter::count)];  // index in the read() buffer
+    int  _opened        = 0;
+    int  _error         = 0;
+    bool _excludeKernel = false;  // perf_event_paranoid >= 2
+
+    int _open(PerfCounter counter);
+};
+
+// ==========================================================================
+enum class PerfStage {
+    touchCycle,         // TouchWorker::dutyCycle
+    supervisorRequest,  // Supervisor::onJoystickRequest
+    mecaCycle,          // MecaWorker::dutyCycle
+    count
+};
+
+// ==========================================================================
+// Per-stage distributions of the counters (nodes/enable_perf_counters),
+// reported every nodes/perf_report_period ms by the LogWriter thread and at
+// exit. Every thread opens its own PerfGroup on its first PerfScope; when
+// perf events are not permitted a warning is logged once and the scopes
+// of that thread do nothing.
+class PerfMonitor {  // singleton
+  public:
+    static PerfMonitor& getInstance();
+
+    static bool isEnabled();   // fast path of PerfScope
+    PerfGroup*  getGroup();    // of the calling thread, null if unavailable
+    void        record(PerfStage stage, const quint64* deltas);
+    QString     getSummary(PerfStage stage) const;
+
+    void poll();    // LogWriter thread
+    void report();  // e.g. at exit
+
+  private:
+    struct Stage {
+        QString              name;
+        std::atomic<quint64> count;
+        std::atomic<quint64> totals[int(PerfCounter::count)];
+        LatencyHistogram*    histograms[int(PerfCounter::count)];
+    };
+
+    static bool   _enabled;
+    Stage         _stages[int(PerfStage::count)];
+    QElapsedTimer _timer;
+    qint64        _period = 0;  // [ms], 0 = at exit only
+
+    PerfMonitor();
+    ~PerfMonitor();
+    PerfMonitor(const PerfMonitor&) = delete;
+    void operator=(const PerfMonitor&) = delete;
+};
+
+// ==========================================================================
+// Counters read at construction and destruction, the deltas are recorded
+// in the stage
+class PerfScope {
+  public:
+    explicit PerfScope(PerfStage stage);
+    PerfScope(const PerfScope&) = delete;
+    PerfScope(PerfScope&&)      = delete;
+    ~PerfScope();
+
+  private:
+    const PerfStage _stage;
+    PerfGroup*      _group = nullptr;
+    quint64         _start[int(PerfCounter::count)];
+};
+
+}  // namespace teleop
+
+
+#endif  // PERF_COUNTERS_H
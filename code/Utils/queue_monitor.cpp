@@ -0,0 +1,154 @@
+#include "queue_monitor.h"
+#include "logs.h"
+#include "settings.h"
+
+#include <QDebug>
+
+
+// ==========================================================================
+teleop::QueueProbe::QueueProbe(const QString& name)
+    : _name(name), _enabled(false), _stamps(1024), _posted(0),
+      _delivered(0), _lost(0), _stale(0), _coalesced(0), _maxDepth(0),
+      _latency(name) {
+}
+
+
+void teleop::QueueProbe::enable() {
+    _enabled.store(true, std::memory_order_relaxed);
+}
+
+
+void teleop::QueueProbe::post() {
+    if (!_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const quint64 posted = _posted.fetch_add(1, std::memory_order_relaxed) + 1;
+    Stamp         stamp;
+    stamp.sequence = posted;
+    stamp.ticks    = LogClock::getInstance().getTicks();
+    // a full ring (receiver stuck) leaves the post without a stamp
+    if (!_stamps.tryPush(stamp)) {
+        _lost.fetch_add(1, std::memory_order_relaxed);
+    }
+    const quint64 depth = posted - _delivered.load(std::memory_order_relaxed);
+    if (depth > _maxDepth.load(std::memory_order_relaxed)) {
+        _maxDepth.store(depth, std::memory_order_relaxed);
+    }
+}
+
+
+void teleop::QueueProbe::deliver() {
+    if (!_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const quint64 delivered =
+        _delivered.fetch_add(1, std::memory_order_relaxed) + 1;
+    // after lost stamps the popped one belongs to a later post: keep it
+    if (_next.sequence < delivered) {
+        _stamps.tryPop(_next);
+    }
+    if (_next.sequence == delivered) {
+        auto&         clock = LogClock::getInstance();
+        const quint64 now   = clock.toNanoseconds(clock.getTicks());
+        const quint64 then  = clock.toNanoseconds(_next.ticks);
+        _latency.record(now > then ? now - then : 0);
+    }
+    if (_posted.load(std::memory_order_relaxed) > delivered) {
+        _stale.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+void teleop::QueueProbe::coalesce() {
+    _coalesced.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+teleop::QueueProbe::Snapshot teleop::QueueProbe::getSnapshot() const {
+    Snapshot snapshot;
+    snapshot.name      = _name;
+    snapshot.delivered = _delivered.load(std::memory_order_relaxed);
+    snapshot.posted    = _posted.load(std::memory_order_relaxed);
+    snapshot.lost      = _lost.load(std::memory_order_relaxed);
+    snapshot.stale     = _stale.load(std::memory_order_relaxed);
+    snapshot.coalesced = _coalesced.load(std::memory_order_relaxed);
+    snapshot.depth     = snapshot.posted > snapshot.delivered
+                             ? snapshot.posted - snapshot.delivered
+                             : 0;
+    snapshot.maxDepth   = _maxDepth.load(std::memory_order_relaxed);
+    snapshot.latencyP50 = _latency.getPercentile(50);
+    snapshot.latencyP99 = _latency.getPercentile(99);
+    snapshot.latencyMax = _latency.getMax();
+    return snapshot;
+}
+
+
+QString teleop::QueueProbe::getSummary() const {
+    const auto s = getSnapshot();
+    return QString("%1: posted=%2 delivered=%3 lost=%4 depth=%5 "
+                   "max_depth=%6 stale=%7 coalesced=%8 | p50=%9us p99=%10us "
+                   "max=%11us")
+        .arg(s.name)
+        .arg(s.posted)
+        .arg(s.delivered)
+        .arg(s.lost)
+        .arg(s.depth)
+        .arg(s.maxDepth)
+        .arg(s.stale)
+        .arg(s.coalesced)
+        .arg(s.latencyP50 * 1e-3, 0, 'f', 1)
+        .arg(s.latencyP99 * 1e-3, 0, 'f', 1)
+        .arg(s.latencyMax * 1e-3, 0, 'f', 1);
+}
+
+
+// ==========================================================================
+teleop::QueueMonitor& teleop::QueueMonitor::getInstance() {
+    static QueueMonitor instance;
+    return instance;
+}
+
+
+teleop::QueueMonitor::QueueMonitor() {
+    _probes[int(QueueLink::touchRequest)] =
+        new QueueProbe("queue touch->supervisor");
+    _probes[int(QueueLink::robotRequest)] =
+        new QueueProbe("queue supervisor->meca_node");
+    _probes[int(QueueLink::touchFeedback)] =
+        new QueueProbe("queue supervisor->touch_node");
+    _probes[int(QueueLink::robotFeedback)] =
+        new QueueProbe("queue meca_adapter->meca_worker");
+    _period = SettingsManager::getInstance().getUnsigned(
+        "nodes/queue_report_period");
+    _timer.start();
+}
+
+
+teleop::QueueMonitor::~QueueMonitor() {
+    for (auto probe : _probes) {
+        delete probe;
+    }
+}
+
+
+teleop::QueueProbe& teleop::QueueMonitor::getProbe(QueueLink link) {
+    return *_probes[int(link)];
+}
+
+
+void teleop::QueueMonitor::poll() {
+    if (_period == 0 || _timer.elapsed() < _period) {
+        return;
+    }
+    _timer.restart();
+    report();
+}
+
+
+void teleop::QueueMonitor::report() {
+    for (auto probe : _probes) {
+        if (probe->getSnapshot().posted > 0) {
+            qInfo(logLogger()).noquote() << probe->getSummary();
+        }
+    }
+}
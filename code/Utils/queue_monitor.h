@@ -0,0 +1,110 @@
+#ifndef QUEUE_MONITOR_H
+#define QUEUE_MONITOR_H
+
+#include "latency.h"
+#include "ring_buffer.h"
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <atomic>
+
+
+namespace teleop {
+
+// ==========================================================================
+// A Qt::QueuedConnection of the pipeline: the emitter calls post() just
+// before the emit, the slot calls deliver() first. The queue is FIFO, so the
+// post stamps wait in a SPSC ring and the n-th delivery is paired with the
+// stamp of the n-th post:
+// - latency:   post -> delivery (time spent in the receiver event queue)
+// - lost:      posts that found the stamp ring full (receiver stuck): their
+//              deliveries are not in the latency
+// - depth:     posted - delivered, the events still in the queue
+// - stale:     deliveries with a newer event of the same link already queued
+// - coalesced: values overwritten in a worker mailbox before the worker
+//              loop consumed them (see MecaWorker/TouchWorker)
+// Only enabled links count (e.g. no robot: requestForRobot is never
+// delivered).
+class QueueProbe {
+  public:
+    struct Snapshot {
+        QString name;
+        quint64 posted;
+        quint64 delivered;
+        quint64 lost;
+        quint64 stale;
+        quint64 coalesced;
+        quint64 depth;
+        quint64 maxDepth;
+        quint64 latencyP50;  // [ns]
+        quint64 latencyP99;  // [ns]
+        quint64 latencyMax;  // [ns]
+    };
+
+    explicit QueueProbe(const QString& name);
+    QueueProbe(const QueueProbe&) = delete;
+    QueueProbe(QueueProbe&&)      = delete;
+
+    void     enable();
+    void     post();      // emitter thread
+    void     deliver();   // receiver thread
+    void     coalesce();  // mailbox owner
+    Snapshot getSnapshot() const;
+    QString  getSummary() const;
+
+  private:
+    struct Stamp {
+        quint64 sequence = 0;  // number of the post, from 1
+        quint64 ticks    = 0;  // LogClock
+    };
+
+    const QString        _name;
+    std::atomic<bool>    _enabled;
+    SpscRing<Stamp>      _stamps;  // of the pending posts
+    Stamp                _next;    // receiver: popped, its post not delivered
+    std::atomic<quint64> _posted;
+    std::atomic<quint64> _delivered;
+    std::atomic<quint64> _lost;
+    std::atomic<quint64> _stale;
+    std::atomic<quint64> _coalesced;
+    std::atomic<quint64> _maxDepth;
+    LatencyHistogram     _latency;
+};
+
+// ==========================================================================
+enum class QueueLink {
+    touchRequest,   // TouchNode::request -> Supervisor
+    robotRequest,   // Supervisor::requestForRobot -> MecaNode
+    touchFeedback,  // Supervisor::feedbackForJoystick -> TouchNode
+    robotFeedback,  // MecaAdapter::feedback -> MecaWorker
+    count
+};
+
+// ==========================================================================
+// Probes of the queued connections, reported every
+// nodes/queue_report_period ms by the LogWriter thread and at exit.
+class QueueMonitor {  // singleton
+  public:
+    static QueueMonitor& getInstance();
+
+    QueueProbe& getProbe(QueueLink link);
+
+    void poll();    // LogWriter thread
+    void report();  // e.g. at exit
+
+  private:
+    QueueProbe*   _probes[int(QueueLink::count)];
+    QElapsedTimer _timer;
+    qint64        _period = 0;  // [ms], 0 = at exit only
+
+    QueueMonitor();
+    ~QueueMonitor();
+    QueueMonitor(const QueueMonitor&) = delete;
+    void operator=(const QueueMonitor&) = delete;
+};
+
+}  // namespace teleop
+
+
+#endif  // QUEUE_MONITOR_H
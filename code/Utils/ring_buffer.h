@@ -0,0 +1,227 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+
+
+namespace teleop {
+
+// ==========================================================================
+// Wait-free single-producer/single-consumer ring buffer.
+// - tryPush must be called by one thread only (the producer)
+// - tryPop must be called by one thread only (the consumer)
+// The capacity is rounded up to the next power of two. Head and tail live on
+// separate cache lines and each side caches the last seen index of the other
+// one, so a push usually touches only producer-owned memory.
+template <typename T>
+class SpscRing {
+  public:
+    explicit SpscRing(unsigned capacity);
+    SpscRing(const SpscRing&) = delete;
+    SpscRing(SpscRing&&)      = delete;
+    ~SpscRing();
+
+    bool     tryPush(const T& item);  // false if full (item not stored)
+    bool     tryPop(T& item);         // false if empty
+    unsigned size() const;            // approximate if called concurrently
+    unsigned capacity() const;
+
+  private:
+    static const std::size_t _cacheLine = 64;
+
+    // shared, read-mostly
+    const unsigned _mask;
+    T* const       _data;
+    char           _pad0[_cacheLine];
+    // producer side
+    std::atomic<unsigned> _head;
+    unsigned              _cachedTail = 0;
+    char                  _pad1[_cacheLine];
+    // consumer side
+    std::atomic<unsigned> _tail;
+    unsigned              _cachedHead = 0;
+    char                  _pad2[_cacheLine];
+
+    static unsigned _roundUp(unsigned value);
+
+    template <typename U>
+    friend class MpmcRing;
+};
+
+
+// ==========================================================================
+template <typename T>
+SpscRing<T>::SpscRing(unsigned capacity)
+    : _mask(_roundUp(capacity) - 1), _data(new T[_mask + 1]), _head(0),
+      _tail(0) {
+}
+
+
+template <typename T>
+SpscRing<T>::~SpscRing() {
+    delete[] _data;
+}
+
+
+template <typename T>
+bool SpscRing<T>::tryPush(const T& item) {
+    const unsigned head = _head.load(std::memory_order_relaxed);
+    if (head - _cachedTail > _mask) {
+        _cachedTail = _tail.load(std::memory_order_acquire);
+        if (head - _cachedTail > _mask) {
+            return false;
+        }
+    }
+    _data[head & _mask] = item;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+
+template <typename T>
+bool SpscRing<T>::tryPop(T& item) {
+    const unsigned tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _cachedHead) {
+        _cachedHead = _head.load(std::memory_order_acquire);
+        if (tail == _cachedHead) {
+            return false;
+        }
+    }
+    item = _data[tail & _mask];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+
+template <typename T>
+unsigned SpscRing<T>::size() const {
+    return _head.load(std::memory_order_acquire) -
+           _tail.load(std::memory_order_acquire);
+}
+
+
+template <typename T>
+unsigned SpscRing<T>::capacity() const {
+    return _mask + 1;
+}
+
+
+template <typename T>
+unsigned SpscRing<T>::_roundUp(unsigned value) {
+    unsigned result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+
+// ==========================================================================
+// Lock-free bounded multi-producer/multi-consumer queue (D. Vyukov).
+// Every slot carries a sequence number: a producer claims a slot with a CAS
+// on the head and publishes it by bumping the slot sequence, so a push never
+// waits for another thread and a full queue fails immediately.
+template <typename T>
+class MpmcRing {
+  public:
+    explicit MpmcRing(unsigned capacity);
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing(MpmcRing&&)      = delete;
+    ~MpmcRing();
+
+    bool     tryPush(const T& item);  // false if full (item not stored)
+    bool     tryPop(T& item);         // false if empty
+    unsigned capacity() const;
+
+  private:
+    static const std::size_t _cacheLine = 64;
+
+    struct Slot {
+        std::atomic<unsigned> sequence;
+        T                     item;
+    };
+
+    const unsigned _mask;
+    Slot* const    _slots;
+    char           _pad0[_cacheLine];
+    std::atomic<unsigned> _head;
+    char                  _pad1[_cacheLine];
+    std::atomic<unsigned> _tail;
+    char                  _pad2[_cacheLine];
+};
+
+
+// ==========================================================================
+template <typename T>
+MpmcRing<T>::MpmcRing(unsigned capacity)
+    : _mask(SpscRing<T>::_roundUp(capacity) - 1), _slots(new Slot[_mask + 1]),
+      _head(0), _tail(0) {
+    for (unsigned i = 0; i <= _mask; ++i) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+
+template <typename T>
+MpmcRing<T>::~MpmcRing() {
+    delete[] _slots;
+}
+
+
+template <typename T>
+bool MpmcRing<T>::tryPush(const T& item) {
+    unsigned head = _head.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot&    slot     = _slots[head & _mask];
+        unsigned sequence = slot.sequence.load(std::memory_order_acquire);
+        int      diff     = int(sequence - head);
+        if (diff == 0) {
+            if (_head.compare_exchange_weak(head, head + 1,
+                                            std::memory_order_relaxed)) {
+                slot.item = item;
+                slot.sequence.store(head + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // full
+        } else {
+            head = _head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+
+template <typename T>
+bool MpmcRing<T>::tryPop(T& item) {
+    unsigned tail = _tail.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot&    slot     = _slots[tail & _mask];
+        unsigned sequence = slot.sequence.load(std::memory_order_acquire);
+        int      diff     = int(sequence - (tail + 1));
+        if (diff == 0) {
+            if (_tail.compare_exchange_weak(tail, tail + 1,
+                                            std::memory_order_relaxed)) {
+                item = slot.item;
+                slot.sequence.store(tail + _mask + 1,
+                                    std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // empty
+        } else {
+            tail = _tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+
+template <typename T>
+unsigned MpmcRing<T>::capacity() const {
+    return _mask + 1;
+}
+
+}  // namespace teleop
+
+
+#endif  // RING_BUFFER_H
@@ -0,0 +1,226 @@
+#include "sched_sampler.h"
+#include "log_session.h"
+#include "logs.h"
+#include "settings.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+// ==========================================================================
+namespace {
+
+QByteArray readProcFile(qint64 tid, const char* name) {
+    QFile file(QString("/proc/self/task/%1/%2").arg(tid).arg(name));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+
+// value of the "key: value" line of /proc/.../status or sched, -1 if missing
+qint64 findField(const QByteArray& text, const QByteArray& key) {
+    for (const auto& line : text.split('\n')) {
+        const int colon = line.indexOf(':');
+        if (colon > 0 && line.left(colon).trimmed() == key) {
+            return line.mid(colon + 1).trimmed().toLongLong();
+        }
+    }
+    return -1;
+}
+
+}  // namespace
+
+
+// ==========================================================================
+teleop::SchedSampler& teleop::SchedSampler::getInstance() {
+    static SchedSampler instance;
+    return instance;
+}
+
+
+void teleop::SchedSampler::attach(const QString& name) {
+    Entry entry;
+    entry.name = name;
+#ifdef __linux__
+    entry.tid = syscall(SYS_gettid);
+#else
+    entry.tid = 0;
+#endif
+    entry.alive = read(entry.tid, entry.first);
+    entry.last  = entry.first;
+
+    auto&         metrics = MetricsRegistry::getInstance();
+    const QString labels  = QString("thread=\"%1\"").arg(name);
+    entry.runMetric =
+        &metrics.getCounter("teleop_thread_run_nanoseconds_total",
+                            "Time spent on a cpu", labels);
+    entry.waitMetric =
+        &metrics.getCounter("teleop_thread_wait_nanoseconds_total",
+                            "Time spent runnable, waiting for a cpu", labels);
+    entry.voluntaryMetric =
+        &metrics.getCounter("teleop_thread_voluntary_switches_total",
+                            "Context switches of the thread (sleep, I/O)",
+                            labels);
+    entry.involuntaryMetric =
+        &metrics.getCounter("teleop_thread_involuntary_switches_total",
+                            "Preemptions of the thread", labels);
+    entry.migrationsMetric = &metrics.getCounter(
+        "teleop_thread_migrations_total", "Cpu migrations of the thread",
+        labels);
+    entry.cpuMetric = &metrics.getGauge("teleop_thread_cpu",
+                                        "Last cpu of the thread", labels);
+
+    // the channel is registered now, before the records of the session
+    auto& settings = SettingsManager::getInstance();
+    if (settings.getBool("nodes/enable_logging_sched") &&
+        settings.getUnsigned("nodes/sched_sample_period") != 0) {
+        if (settings.getLogMode("nodes/log_mode") == LogMode::session &&
+            LogSession::getInstance().isChannelTableWritten()) {
+            qWarning(logLogger()) << "SchedSampler:" << name
+                                  << "attached after the first session "
+                                     "record, not logged";
+        } else {
+            entry.logger = new Logger("sched_" + name.toLower(),
+                                      LOG_UNITS_SCHED,
+                                      settings.getUnsigned("nodes/log_size"));
+            entry.logger->moveToThread(this);  // deleted by run()
+        }
+    }
+
+    _mutex.lock();
+    _entries.append(entry);
+    _mutex.unlock();
+}
+
+
+void teleop::SchedSampler::enable() {
+    auto& settings = SettingsManager::getInstance();
+    _period        = settings.getUnsigned("nodes/sched_sample_period");
+    if (_period != 0 && !isRunning()) {
+        start(QThread::LowPriority);
+    }
+}
+
+
+void teleop::SchedSampler::disable() {
+    requestInterruption();
+    wait();
+}
+
+
+void teleop::SchedSampler::report() {
+    _mutex.lock();
+    for (auto& entry : _entries) {
+        SchedStats now = entry.last;
+        if (entry.alive) {
+            read(entry.tid, now);
+        }
+        const quint64 run  = now.runTime - entry.first.runTime;
+        const quint64 wait = now.waitTime - entry.first.waitTime;
+        qInfo(logLogger()).noquote()
+            << QString("sched %1 (tid %2): run=%3ms wait=%4ms (%5%) "
+                       "voluntary=%6 involuntary=%7 migrations=%8 cpu=%9")
+                   .arg(entry.name)
+                   .arg(entry.tid)
+                   .arg(run * 1e-6, 0, 'f', 1)
+                   .arg(wait * 1e-6, 0, 'f', 1)
+                   .arg(run + wait > 0 ? 100.0 * wait / (run + wait) : 0.0,
+                        0, 'f', 2)
+                   .arg(now.voluntary - entry.first.voluntary)
+                   .arg(now.involuntary - entry.first.involuntary)
+                   .arg(now.migrations - entry.first.migrations)
+                   .arg(now.cpu);
+    }
+    _mutex.unlock();
+}
+
+
+bool teleop::SchedSampler::read(qint64 tid, SchedStats& stats) {
+    // "<run ns> <wait ns> <timeslices>"
+    const auto schedstat = readProcFile(tid, "schedstat").split(' ');
+    if (schedstat.size() < 2) {
+        return false;
+    }
+    stats.runTime  = schedstat[0].toULongLong();
+    stats.waitTime = schedstat[1].toULongLong();
+
+    const QByteArray status = readProcFile(tid, "status");
+    stats.voluntary =
+        qMax<qint64>(0, findField(status, "voluntary_ctxt_switches"));
+    stats.involuntary =
+        qMax<qint64>(0, findField(status, "nonvoluntary_ctxt_switches"));
+
+    // processor is the field 39, the 37th after the "(comm)"
+    const QByteArray stat   = readProcFile(tid, "stat");
+    const auto       fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+    const int        cpu    = fields.size() > 36 ? fields[36].toInt() : -1;
+
+    const qint64 migrations =
+        findField(readProcFile(tid, "sched"), "se.nr_migrations");
+    if (migrations >= 0) {
+        stats.migrations = quint64(migrations);
+    } else if (stats.cpu >= 0 && cpu != stats.cpu) {
+        stats.migrations++;
+    }
+    stats.cpu = cpu;
+    return true;
+}
+
+
+void teleop::SchedSampler::run() {
+    QElapsedTimer timer;
+    timer.start();
+    while (!isInterruptionRequested()) {
+        if (timer.elapsed() >= _period) {
+            timer.restart();
+            _sample();
+        }
+        msleep(_tick);
+    }
+    _sample();
+    _mutex.lock();
+    for (auto& entry : _entries) {
+        delete entry.logger;  // flushed
+        entry.logger = nullptr;
+    }
+    _mutex.unlock();
+}
+
+
+void teleop::SchedSampler::_sample() {
+    _mutex.lock();
+    for (auto& entry : _entries) {
+        SchedStats now = entry.last;
+        if (!entry.alive || !read(entry.tid, now)) {
+            entry.alive = false;
+            continue;
+        }
+        const SchedStats& last        = entry.last;
+        const quint64     run         = now.runTime - last.runTime;
+        const quint64     wait        = now.waitTime - last.waitTime;
+        const quint64     voluntary   = now.voluntary - last.voluntary;
+        const quint64     involuntary = now.involuntary - last.involuntary;
+        const quint64     migrations  = now.migrations - last.migrations;
+        entry.runMetric->increment(run);
+        entry.waitMetric->increment(wait);
+        entry.voluntaryMetric->increment(voluntary);
+        entry.involuntaryMetric->increment(involuntary);
+        entry.migrationsMetric->increment(migrations);
+        entry.cpuMetric->set(now.cpu);
+        if (entry.logger) {
+            entry.logger->write({float(run * 1e-6), float(wait * 1e-6),
+                                 float(voluntary), float(involuntary),
+                                 float(migrations), float(now.cpu)});
+        }
+        entry.last = now;
+    }
+    _mutex.unlock();
+}
@@ -0,0 +1,87 @@
+#ifndef SCHED_SAMPLER_H
+#define SCHED_SAMPLER_H
+
+#include "metrics.h"
+
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+
+namespace teleop {
+
+class Logger;
+
+// ==========================================================================
+// Scheduler statistics of a thread, from /proc/self/task/<tid>/
+struct SchedStats {
+    quint64 runTime     = 0;   // [ns] on a cpu (schedstat)
+    quint64 waitTime    = 0;   // [ns] runnable, waiting for a cpu (schedstat)
+    quint64 voluntary   = 0;   // context switches (status)
+    quint64 involuntary = 0;   // preemptions (status)
+    quint64 migrations  = 0;   // se.nr_migrations (sched)
+    int     cpu         = -1;  // last cpu (stat)
+};
+
+// ==========================================================================
+// Low priority thread reading the SchedStats of the attached threads every
+// nodes/sched_sample_period ms (0: disabled). Each sample is exported as
+// metrics (thread="...") and, with nodes/enable_logging_sched, written to
+// the log channel sched_<thread> as the deltas of the period:
+// run [ms], wait [ms], voluntary, involuntary, migrations, cpu.
+// The channel is created by attach(), so with nodes/log_mode = session a
+// thread must attach before the first record is written: a thread attached
+// later is sampled but not logged.
+// Without se.nr_migrations (no CONFIG_SCHED_DEBUG) the migrations are the
+// cpu changes seen between two samples, a lower bound.
+class SchedSampler : public QThread {  // singleton
+    Q_OBJECT
+
+  public:
+    static SchedSampler& getInstance();
+
+    void attach(const QString& name);  // the calling thread
+    void enable();   // start the thread if a period is set
+    void disable();  // stop the thread
+    void report();   // totals since attach, e.g. at exit
+
+    // stats: the previous sample of the thread, updated. False once the
+    // thread is gone
+    static bool read(qint64 tid, SchedStats& stats);
+
+  protected:
+    void run() override;
+
+  private:
+    struct Entry {
+        QString        name;
+        qint64         tid;
+        bool           alive = true;
+        SchedStats     first;
+        SchedStats     last;
+        Logger*        logger = nullptr;
+        MetricCounter* runMetric;
+        MetricCounter* waitMetric;
+        MetricCounter* voluntaryMetric;
+        MetricCounter* involuntaryMetric;
+        MetricCounter* migrationsMetric;
+        MetricGauge*   cpuMetric;
+    };
+
+    QMutex         _mutex;
+    QVector<Entry> _entries;
+    unsigned       _period     = 0;   // [ms]
+    unsigned       _tick       = 50;  // [ms] between two checks of disable()
+
+    SchedSampler() = default;
+    SchedSampler(const SchedSampler&) = delete;
+    void operator=(const SchedSampler&) = delete;
+
+    void _sample();
+};
+
+}  // namespace teleop
+
+
+#endif  // SCHED_SAMPLER_H
@@ -222,6 +222,12 @@ teleop::FilterType teleop::convertQStringToFilterType(const QString& str) {
         return teleop::FilterType::blp;
     } else if (str == "smmblp") {
         return teleop::FilterType::smmblp;
+    } else if (str == "sos") {
+        return teleop::FilterType::sos;
+    } else if (str == "kalman") {
+        return teleop::FilterType::kalman;
+    } else if (str == "abg") {
+        return teleop::FilterType::abg;
     } else {
         qCritical(logSettings)
             << "Fail to convert string" << str << "in FilterType enum ";
@@ -245,6 +251,12 @@ QString teleop::convertFilterTypeToQString(const teleop::FilterType filter) {
             return "blp";
         case teleop::FilterType::smmblp:
             return "smmblp";
+        case teleop::FilterType::sos:
+            return "sos";
+        case teleop::FilterType::kalman:
+            return "kalman";
+        case teleop::FilterType::abg:
+            return "abg";
         default:
             qCritical(logSettings)
                 << "Fail to convert FeedbackType enum to string";
@@ -254,6 +266,113 @@ QString teleop::convertFilterTypeToQString(const teleop::FilterType filter) {
 }
 
 
+teleop::FilterDesign teleop::convertQStringToFilterDesign(const QString& str) {
+    if (str == "butterworth") {
+        return teleop::FilterDesign::butterworth;
+    } else if (str == "bessel") {
+        return teleop::FilterDesign::bessel;
+    } else if (str == "chebyshev") {
+        return teleop::FilterDesign::chebyshev;
+    } else {
+        qCritical(logSettings)
+            << "Fail to convert string" << str << "in FilterDesign enum ";
+        qCritical(logSettings) << "FATAL";
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+QString
+teleop::convertFilterDesignToQString(const teleop::FilterDesign design) {
+    switch (design) {
+        case teleop::FilterDesign::butterworth:
+            return "butterworth";
+        case teleop::FilterDesign::bessel:
+            return "bessel";
+        case teleop::FilterDesign::chebyshev:
+            return "chebyshev";
+        default:
+            qCritical(logSettings)
+                << "Fail to convert FilterDesign enum to string";
+            qCritical(logSettings) << "FATAL";
+            exit(EXIT_FAILURE);
+    }
+}
+
+
+teleop::LogMode teleop::convertQStringToLogMode(const QString& str) {
+    if (str == "buffered") {
+        return teleop::LogMode::buffered;
+    } else if (str == "async") {
+        return teleop::LogMode::async;
+    } else if (str == "mapped") {
+        return teleop::LogMode::mapped;
+    } else if (str == "session") {
+        return teleop::LogMode::session;
+    } else if (str == "recorder") {
+        return teleop::LogMode::recorder;
+    } else {
+        qCritical(logSettings)
+            << "Fail to convert string" << str << "in LogMode enum ";
+        qCritical(logSettings) << "FATAL";
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+QString teleop::convertLogModeToQString(const teleop::LogMode mode) {
+    switch (mode) {
+        case teleop::LogMode::buffered:
+            return "buffered";
+        case teleop::LogMode::async:
+            return "async";
+        case teleop::LogMode::mapped:
+            return "mapped";
+        case teleop::LogMode::session:
+            return "session";
+        case teleop::LogMode::recorder:
+            return "recorder";
+        default:
+            qCritical(logSettings) << "Fail to convert LogMode enum to string";
+            qCritical(logSettings) << "FATAL";
+            exit(EXIT_FAILURE);
+    }
+}
+
+
+teleop::LogFormat teleop::convertQStringToLogFormat(const QString& str) {
+    if (str == "text") {
+        return teleop::LogFormat::text;
+    } else if (str == "binary") {
+        return teleop::LogFormat::binary;
+    } else if (str == "compressed") {
+        return teleop::LogFormat::compressed;
+    } else {
+        qCritical(logSettings)
+            << "Fail to convert string" << str << "in LogFormat enum ";
+        qCritical(logSettings) << "FATAL";
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+QString teleop::convertLogFormatToQString(const teleop::LogFormat format) {
+    switch (format) {
+        case teleop::LogFormat::text:
+            return "text";
+        case teleop::LogFormat::binary:
+            return "binary";
+        case teleop::LogFormat::compressed:
+            return "compressed";
+        default:
+            qCritical(logSettings)
+                << "Fail to convert LogFormat enum to string";
+            qCritical(logSettings) << "FATAL";
+            exit(EXIT_FAILURE);
+    }
+}
+
+
 // ==========================================================================
 teleop::SettingsManager& teleop::SettingsManager::getInstance() {
     static SettingsManager instance;
@@ -323,6 +442,18 @@ QVector<float> teleop::SettingsManager::getQVector(const QString& key) {
 }
 
 
+teleop::Vec6 teleop::SettingsManager::getVec6(const QString& key) {
+    const QVector<float> vector = getQVector(key);
+    if (vector.size() != Vec6::size()) {
+        qCritical(logSettings) << "Expected" << Vec6::size()
+                               << "values in settings:" << key << vector;
+        qCritical(logSettings) << "FATAL";
+        exit(EXIT_FAILURE);
+    }
+    return Vec6::fromQVector(vector);
+}
+
+
 teleop::Mode teleop::SettingsManager::getMode(const QString& key) {
     _checkKey(key);
     return convertQStringToMode(_data->value(key).toString());
@@ -355,6 +486,25 @@ teleop::FilterType teleop::SettingsManager::getFilterType(const QString& key) {
 }
 
 
+teleop::FilterDesign
+teleop::SettingsManager::getFilterDesign(const QString& key) {
+    _checkKey(key);
+    return convertQStringToFilterDesign(_data->value(key).toString());
+}
+
+
+teleop::LogMode teleop::SettingsManager::getLogMode(const QString& key) {
+    _checkKey(key);
+    return convertQStringToLogMode(_data->value(key).toString());
+}
+
+
+teleop::LogFormat teleop::SettingsManager::getLogFormat(const QString& key) {
+    _checkKey(key);
+    return convertQStringToLogFormat(_data->value(key).toString());
+}
+
+
 void teleop::SettingsManager::_checkKey(const QString& key) {
     if (!_data->contains(key)) {
         qCritical(logSettings) << "Key not found in settings:" << key;
@@ -370,8 +520,31 @@ void teleop::SettingsManager::_initConfigs() {
     _data->setValue("nodes/enable_joystick", false);
     _data->setValue("nodes/enable_logging_slave", false);
     _data->setValue("nodes/enable_logging_filters", false);
+    _data->setValue("nodes/logging_filters_thread", false);
     _data->setValue("nodes/enable_logging_wrench", false);
+    _data->setValue("nodes/enable_logging_sched", false);
     _data->setValue("nodes/log_size", 100000);
+    _data->setValue("nodes/log_mode", convertLogModeToQString(LogMode::async));
+    _data->setValue("nodes/log_format",
+                    convertLogFormatToQString(LogFormat::text));
+    _data->setValue("nodes/log_ring_size", 8192);
+    _data->setValue("nodes/log_writer_period", 50);
+    _data->setValue("nodes/log_segment_size", 16);
+    _data->setValue("nodes/log_precision",
+                    "mm:0.001, deg:0.0001, mm/s:0.001, deg/s:0.001, "
+                    "N:0.0001, Nm:0.0001");
+    _data->setValue("nodes/log_session_slack", 100);
+    _data->setValue("nodes/log_recorder_size", 32768);
+    _data->setValue("nodes/warning_period", 1000);
+    _data->setValue("nodes/enable_tracing", false);
+    _data->setValue("nodes/trace_size", 262144);
+    _data->setValue("nodes/latency_report_period", 10000);
+    _data->setValue("nodes/cycle_report_period", 10000);
+    _data->setValue("nodes/queue_report_period", 10000);
+    _data->setValue("nodes/enable_perf_counters", false);
+    _data->setValue("nodes/perf_report_period", 10000);
+    _data->setValue("nodes/metrics_port", 0);
+    _data->setValue("nodes/sched_sample_period", 1000);
 
     _data->setValue("task/mode", convertModeToQString(Mode::rel));
     _data->setValue("task/relative_mode",
@@ -414,4 +587,17 @@ void teleop::SettingsManager::_initConfigs() {
     _data->setValue("filters/blp",
                     convertQVectorToQString({0.00361257, 0.00722515, 0.00361257,
                                              1.82292669, -0.83737699}));
+    _data->setValue("filters/sos_design",
+                    convertFilterDesignToQString(FilterDesign::butterworth));
+    _data->setValue("filters/sos_order", 2);
+    _data->setValue("filters/sos_cutoff", 20.0);
+    _data->setValue("filters/sos_ripple", 1.0);
+    _data->setValue("filters/deadband",
+                    convertQVectorToQString({0.5, 0.5, 0.5, 0.2, 0.2, 0.2}));
+    _data->setValue(
+        "filters/kalman_noise",
+        convertQVectorToQString({0.03, 0.03, 0.03, 0.05, 0.05, 0.05}));
+    _data->setValue("filters/kalman_jerk",
+                    convertQVectorToQString({1e8, 1e8, 1e8, 1e8, 1e8, 1e8}));
+    _data->setValue("filters/abg_theta", 0.8);
 };
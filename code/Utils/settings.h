@@ -1,6 +1,8 @@
 #ifndef SETTINGS_H
 #define SETTINGS_H
 
+#include "vec.h"
+
 #include <QFile>
 #include <QLoggingCategory>
 #include <QObject>
@@ -19,7 +21,10 @@ enum class Mode { abs, rel, vel };
 enum class RelativeMode { fix, drg, var };
 enum class Movement { lx, ly, lz, sx, sy, sz, sxy, sxz, syx, syz, szx, szy };
 enum class FeedbackType { none, sphere, anchor, linear, triangle, opponent };
-enum class FilterType { none, sma, wma, smm, blp, smmblp };
+enum class FilterType { none, sma, wma, smm, blp, smmblp, sos, kalman, abg };
+enum class FilterDesign { butterworth, bessel, chebyshev };
+enum class LogMode { buffered, async, mapped, session, recorder };
+enum class LogFormat { text, binary, compressed };
 
 // ==========================================================================
 QVector<float> convertQStringToQVector(const QString& str);
@@ -46,6 +51,18 @@ teleop::FilterType convertQStringToFilterType(const QString& str);
 
 QString convertFilterTypeToQString(const teleop::FilterType filter);
 
+teleop::FilterDesign convertQStringToFilterDesign(const QString& str);
+
+QString convertFilterDesignToQString(const teleop::FilterDesign design);
+
+teleop::LogMode convertQStringToLogMode(const QString& str);
+
+QString convertLogModeToQString(const teleop::LogMode mode);
+
+teleop::LogFormat convertQStringToLogFormat(const QString& str);
+
+QString convertLogFormatToQString(const teleop::LogFormat format);
+
 // ==========================================================================
 class SettingsManager {  // singleton
   public:
@@ -59,11 +76,15 @@ class SettingsManager {  // singleton
     unsigned       getUnsigned(const QString& key);
     QString        getQString(const QString& key);
     QVector<float> getQVector(const QString& key);
+    Vec6           getVec6(const QString& key);  // exactly 6 values
     Mode           getMode(const QString& key);
     RelativeMode   getRelativeMode(const QString& key);
     Movement       getMovement(const QString& key);
     FeedbackType   getFeedbackType(const QString& key);
     FilterType     getFilterType(const QString& key);
+    FilterDesign   getFilterDesign(const QString& key);
+    LogMode        getLogMode(const QString& key);
+    LogFormat      getLogFormat(const QString& key);
 
 
   private:
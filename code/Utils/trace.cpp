@@ -0,0 +1,177 @@
+#include "trace.h"
+#include "logs.h"
+#include "settings.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QThread>
+
+
+// ==========================================================================
+teleop::TraceBuffer::TraceBuffer(const QString& thread_name, unsigned capacity)
+    : threadName(thread_name), events(new TraceEvent[capacity]),
+      capacity(capacity), count(0), dropped(0) {
+}
+
+
+teleop::TraceBuffer::~TraceBuffer() {
+    delete[] events;
+}
+
+
+void teleop::TraceBuffer::add(char phase, const char* name, quint64 id) {
+    const unsigned index = count.load(std::memory_order_relaxed);
+    if (index >= capacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceEvent& event = events[index];
+    event.name        = name;
+    event.ticks       = LogClock::getInstance().getTicks();
+    event.id          = id;
+    event.phase       = phase;
+    count.store(index + 1, std::memory_order_release);
+}
+
+
+// ==========================================================================
+bool teleop::Tracer::_enabled = false;
+
+
+teleop::Tracer& teleop::Tracer::getInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+
+teleop::Tracer::Tracer() {
+    auto& settings = SettingsManager::getInstance();
+    _enabled       = settings.getBool("nodes/enable_tracing");
+    _capacity      = settings.getUnsigned("nodes/trace_size");
+}
+
+
+teleop::Tracer::~Tracer() {
+    qDeleteAll(_buffers);
+}
+
+
+bool teleop::Tracer::isEnabled() {
+    getInstance();  // read the settings once
+    return _enabled;
+}
+
+
+void teleop::Tracer::setThreadName(const QString& name) {
+    if (!isEnabled()) {
+        return;
+    }
+    auto buffer = getBuffer();
+    _mutex.lock();
+    buffer->threadName = name;
+    _mutex.unlock();
+}
+
+
+teleop::TraceBuffer* teleop::Tracer::getBuffer() {
+    // allocated once per thread and kept until exit, for the export
+    static thread_local TraceBuffer* buffer = nullptr;
+    if (!buffer) {
+        _mutex.lock();
+        buffer = new TraceBuffer(
+            QString("thread %1").arg(_buffers.size()), _capacity);
+        _buffers.append(buffer);
+        _mutex.unlock();
+    }
+    return buffer;
+}
+
+
+bool teleop::Tracer::exportJson(const QString& path) {
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly)) {
+        qWarning(logLogger()) << "Tracer: cannot open" << path
+                              << file.errorString();
+        return false;
+    }
+    auto&      clock = LogClock::getInstance();
+    QByteArray chunk = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool       first = true;
+    _mutex.lock();
+    for (int tid = 0; tid < _buffers.size(); ++tid) {
+        const TraceBuffer* buffer = _buffers[tid];
+        chunk += first ? "" : ",\n";
+        chunk += "{\"ph\":\"M\",\"pid\":1,\"tid\":" + QByteArray::number(tid) +
+                 ",\"name\":\"thread_name\",\"args\":{\"name\":\"" +
+                 buffer->threadName.toUtf8() + "\"}}";
+        first = false;
+
+        const unsigned count = buffer->count.load(std::memory_order_acquire);
+        for (unsigned i = 0; i < count; ++i) {
+            const TraceEvent& event = buffer->events[i];
+            // [us] with ns resolution
+            const double ts = clock.toNanoseconds(event.ticks) * 1e-3;
+            chunk += ",\n{\"ph\":\"";
+            chunk += event.phase;
+            chunk += "\",\"pid\":1,\"tid\":" + QByteArray::number(tid) +
+                     ",\"ts\":" + QByteArray::number(ts, 'f', 3) +
+                     ",\"name\":\"" + event.name + "\"";
+            if (event.phase == 's' || event.phase == 't' ||
+                event.phase == 'f') {
+                chunk += ",\"cat\":\"flow\",\"id\":" +
+                         QByteArray::number(event.id);
+                if (event.phase == 'f') {
+                    chunk += ",\"bp\":\"e\"";
+                }
+            }
+            chunk += "}";
+            if (chunk.size() > (1 << 20)) {
+                file.write(chunk);
+                chunk.clear();
+            }
+        }
+        const quint64 dropped = buffer->dropped.load();
+        if (dropped > 0) {
+            qWarning(logLogger()) << "Tracer:" << buffer->threadName
+                                  << "dropped" << dropped
+                                  << "events: buffer full";
+        }
+    }
+    _mutex.unlock();
+    chunk += "\n]}\n";
+    file.write(chunk);
+    file.close();
+    qInfo(logLogger()) << "Tracer: written" << path;
+    return true;
+}
+
+
+void teleop::Tracer::exportJson() {
+    if (!isEnabled()) {
+        return;
+    }
+    QString dir_path = SettingsManager::getInstance().getDirectoryPath() +
+                       "/logs/";
+    QDir dir;
+    if (!dir.exists(dir_path)) {
+        dir.mkpath(dir_path);
+    }
+    exportJson(dir_path + "trace.json");
+}
+
+
+// ==========================================================================
+teleop::TraceSpan::TraceSpan(const char* name) : _name(name) {
+    if (Tracer::isEnabled()) {
+        _buffer = Tracer::getInstance().getBuffer();
+        _buffer->add('B', _name);
+    }
+}
+
+
+teleop::TraceSpan::~TraceSpan() {
+    if (_buffer) {
+        _buffer->add('E', _name);
+    }
+}
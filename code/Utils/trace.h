@@ -0,0 +1,106 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+
+namespace teleop {
+
+// ==========================================================================
+// Event of a TraceBuffer: name must be a string literal (not copied)
+struct TraceEvent {
+    const char* name;
+    quint64     ticks;  // LogClock
+    quint64     id;     // flow events only
+    char        phase;  // Chrome trace phase: B, E, s, t, f
+};
+
+// ==========================================================================
+// Events of a single thread: written only by the owner, read by the export.
+// When full the new events are dropped and counted.
+class TraceBuffer {
+  public:
+    TraceBuffer(const QString& thread_name, unsigned capacity);
+    TraceBuffer(const TraceBuffer&) = delete;
+    TraceBuffer(TraceBuffer&&)      = delete;
+    ~TraceBuffer();
+
+    void add(char phase, const char* name, quint64 id = 0);
+
+    QString           threadName;
+    TraceEvent* const events;
+    const unsigned    capacity;
+    std::atomic<unsigned> count;
+    std::atomic<quint64>  dropped;
+};
+
+// ==========================================================================
+// Span tracing of the control pipeline (nodes/enable_tracing).
+// Every thread records into its own TraceBuffer, without locks: a span is
+// two events with a raw LogClock timestamp. Flow events link the spans that
+// handle the same touch sample across the threads and the queued signals.
+// exportJson() writes the Chrome trace-event format (chrome://tracing,
+// ui.perfetto.dev); main() exports logs/trace.json at exit.
+class Tracer {  // singleton
+  public:
+    static Tracer& getInstance();
+
+    static bool  isEnabled();  // fast path of the macros
+    void         setThreadName(const QString& name);
+    TraceBuffer* getBuffer();  // of the calling thread
+    bool         exportJson(const QString& path);
+    void         exportJson();  // logs/trace.json, if enabled
+
+  private:
+    static bool           _enabled;
+    QMutex                _mutex;
+    QVector<TraceBuffer*> _buffers;
+    unsigned              _capacity = 0;
+
+    Tracer();
+    ~Tracer();
+    Tracer(const Tracer&) = delete;
+    void operator=(const Tracer&) = delete;
+};
+
+// ==========================================================================
+// Begin/end span of a scope (see TELEOP_TRACE_SCOPE)
+class TraceSpan {
+  public:
+    explicit TraceSpan(const char* name);
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan(TraceSpan&&)      = delete;
+    ~TraceSpan();
+
+  private:
+    const char* const _name;
+    TraceBuffer*      _buffer = nullptr;
+};
+
+}  // namespace teleop
+
+// ==========================================================================
+#define TELEOP_TRACE_CONCAT_(a, b) a##b
+#define TELEOP_TRACE_CONCAT(a, b) TELEOP_TRACE_CONCAT_(a, b)
+
+// span from here to the end of the scope
+#define TELEOP_TRACE_SCOPE(name) \
+    teleop::TraceSpan TELEOP_TRACE_CONCAT(_traceSpan, __LINE__)(name)
+
+// flow of a sample: begin, step and end inside a span (binding point)
+#define TELEOP_TRACE_FLOW(phase, name, id)                                   \
+    do {                                                                     \
+        if (teleop::Tracer::isEnabled()) {                                   \
+            teleop::Tracer::getInstance().getBuffer()->add(phase, name, id); \
+        }                                                                    \
+    } while (0)
+#define TELEOP_TRACE_FLOW_BEGIN(name, id) TELEOP_TRACE_FLOW('s', name, id)
+#define TELEOP_TRACE_FLOW_STEP(name, id) TELEOP_TRACE_FLOW('t', name, id)
+#define TELEOP_TRACE_FLOW_END(name, id) TELEOP_TRACE_FLOW('f', name, id)
+
+
+#endif  // TRACE_H
@@ -0,0 +1,222 @@
+#ifndef VEC_H
+#define VEC_H
+
+#include <QDebug>
+#include <QMetaType>
+#include <QVector>
+#include <QtMath>
+
+#include <initializer_list>
+#include <type_traits>
+
+
+namespace teleop {
+
+// ==========================================================================
+// Fixed-size vector of floats passed by value along the pipeline (poses,
+// twists, wrenches): no heap allocation and no reference counting, and
+// trivially copyable, so a queued connection copies it as a plain block.
+// Zero-initialized; a shorter initializer list leaves the remaining
+// components at zero: Vec6 pose = {x, y, z};
+template <int N>
+struct alignas(16) Vec {
+    float values[N];
+
+    Vec();
+    Vec(std::initializer_list<float> list);
+
+    static constexpr int size() { return N; }
+
+    float&       operator[](int i) { return values[i]; }
+    const float& operator[](int i) const { return values[i]; }
+    float*       begin() { return values; }
+    float*       end() { return values + N; }
+    const float* begin() const { return values; }
+    const float* end() const { return values + N; }
+
+    Vec& operator+=(const Vec& other);
+    Vec& operator-=(const Vec& other);
+    Vec& operator*=(float factor);
+    Vec& operator/=(float factor);
+
+    float dot(const Vec& other) const;
+    float norm() const;
+    template <int M>
+    Vec<M> head() const;  // first M components
+
+    QVector<float> toQVector() const;
+    static Vec     fromQVector(const QVector<float>& vector);  // 0 if short
+};
+
+using Vec3 = Vec<3>;
+using Vec6 = Vec<6>;
+
+static_assert(std::is_trivially_copyable<Vec3>::value,
+              "Vec3 is copied as a plain block");
+static_assert(std::is_trivially_copyable<Vec6>::value,
+              "Vec6 is copied as a plain block");
+
+template <int N>
+Vec<N> operator+(Vec<N> a, const Vec<N>& b) {
+    return a += b;
+}
+
+template <int N>
+Vec<N> operator-(Vec<N> a, const Vec<N>& b) {
+    return a -= b;
+}
+
+template <int N>
+Vec<N> operator-(Vec<N> a) {
+    return a *= -1;
+}
+
+template <int N>
+Vec<N> operator*(Vec<N> a, float factor) {
+    return a *= factor;
+}
+
+template <int N>
+Vec<N> operator*(float factor, Vec<N> a) {
+    return a *= factor;
+}
+
+template <int N>
+Vec<N> operator/(Vec<N> a, float factor) {
+    return a /= factor;
+}
+
+template <int N>
+bool operator==(const Vec<N>& a, const Vec<N>& b) {
+    for (int i = 0; i < N; ++i) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int N>
+bool operator!=(const Vec<N>& a, const Vec<N>& b) {
+    return !(a == b);
+}
+
+template <int N>
+QDebug operator<<(QDebug debug, const Vec<N>& vec) {
+    QDebugStateSaver saver(debug);
+    debug.nospace() << "Vec" << N << "(";
+    for (int i = 0; i < N; ++i) {
+        debug << (i > 0 ? ", " : "") << vec[i];
+    }
+    debug << ")";
+    return debug;
+}
+
+
+// ==========================================================================
+template <int N>
+Vec<N>::Vec() : values() {
+}
+
+
+template <int N>
+Vec<N>::Vec(std::initializer_list<float> list) : values() {
+    int i = 0;
+    for (float value : list) {
+        if (i == N) {
+            break;
+        }
+        values[i++] = value;
+    }
+}
+
+
+template <int N>
+Vec<N>& Vec<N>::operator+=(const Vec& other) {
+    for (int i = 0; i < N; ++i) {
+        values[i] += other.values[i];
+    }
+    return *this;
+}
+
+
+template <int N>
+Vec<N>& Vec<N>::operator-=(const Vec& other) {
+    for (int i = 0; i < N; ++i) {
+        values[i] -= other.values[i];
+    }
+    return *this;
+}
+
+
+template <int N>
+Vec<N>& Vec<N>::operator*=(float factor) {
+    for (int i = 0; i < N; ++i) {
+        values[i] *= factor;
+    }
+    return *this;
+}
+
+
+template <int N>
+Vec<N>& Vec<N>::operator/=(float factor) {
+    for (int i = 0; i < N; ++i) {
+        values[i] /= factor;
+    }
+    return *this;
+}
+
+
+template <int N>
+float Vec<N>::dot(const Vec& other) const {
+    float result = 0;
+    for (int i = 0; i < N; ++i) {
+        result += values[i] * other.values[i];
+    }
+    return result;
+}
+
+
+template <int N>
+float Vec<N>::norm() const {
+    return qSqrt(dot(*this));
+}
+
+
+template <int N>
+template <int M>
+Vec<M> Vec<N>::head() const {
+    static_assert(M <= N, "head() longer than the vector");
+    Vec<M> result;
+    for (int i = 0; i < M; ++i) {
+        result[i] = values[i];
+    }
+    return result;
+}
+
+
+template <int N>
+QVector<float> Vec<N>::toQVector() const {
+    return QVector<float>(begin(), end());
+}
+
+
+template <int N>
+Vec<N> Vec<N>::fromQVector(const QVector<float>& vector) {
+    Vec result;
+    for (int i = 0; i < N && i < vector.size(); ++i) {
+        result[i] = vector[i];
+    }
+    return result;
+}
+
+}  // namespace teleop
+
+Q_DECLARE_METATYPE(teleop::Vec3)
+Q_DECLARE_METATYPE(teleop::Vec6)
+// QVector moves them with memcpy and does not run their ctors/dtors
+Q_DECLARE_TYPEINFO(teleop::Vec3, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(teleop::Vec6, Q_PRIMITIVE_TYPE);
+
+
+#endif  // VEC_H
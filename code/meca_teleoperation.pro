@@ -6,11 +6,15 @@ SUBDIRS += \
     TouchNode \
     MecaNode \
     Main \
+    LogConverter \
+    Bench \
 
-Main.depends       = Utils Supervisor
-Supervisor.depends = Utils TouchNode MecaNode
-TouchNode.depends  = Utils
-MecaNode.depends   = Utils
+Main.depends         = Utils Supervisor
+Supervisor.depends   = Utils TouchNode MecaNode
+TouchNode.depends    = Utils
+MecaNode.depends     = Utils
+LogConverter.depends = Utils
+Bench.depends        = Utils MecaNode
 
 OTHER_FILES += \
     .gitignore \